@@ -33,6 +33,13 @@
 //
 - (nullable instancetype)initWithDevice:(nonnull id<MTLDevice>)device;
 
+// • Initialization with the field initialization, rule and warm-up of a rule
+//      search result (nil if the file cannot be read or has no such rank)
+//
+- (nullable instancetype)initWithDevice:(nonnull id<MTLDevice>)device
+                            ruleFileURL:(nullable NSURL *)ruleFileURL
+                                   rank:(NSUInteger)rank;
+
 // • Properties (Field Initialization)
 //
 @property (nonnull, nonatomic, readonly) id<MTLBuffer> fieldInitBuffer;
@@ -45,6 +52,9 @@
 //
 @property (nonnull, nonatomic, readonly) id<MTLBuffer> ruleBuffer;
 @property (nonatomic, readonly) NSInteger ruleOffset;
+@property (nonatomic, readonly) NSInteger neighborhoodRadius;
+@property (nonatomic, readonly) uint8_t neighborhoodTopology;
+@property (nonatomic, readonly) MTLPixelFormat fieldPixelFormat;
 
 // • Properties (Colorization)
 //
@@ -68,9 +78,15 @@
 //
 @property (nonatomic, readonly) BOOL shouldStepNext;
 @property (nonatomic, readonly) uint8_t currentSubstep;
+@property (nonatomic, readonly) uint8_t stepDuration;
 
 // • Methods (State)
 //
 - (void)nextSubstep;
 
+// • Methods (Field Checkpoint)
+//
+- (BOOL)loadFieldCheckpointIntoTexture:(nonnull id<MTLTexture>)fieldTexture;
+- (void)storeFieldCheckpointFromBuffer:(nonnull id<MTLBuffer>)fieldBuffer;
+
 @end
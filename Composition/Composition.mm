@@ -21,6 +21,10 @@
 
 #import <Data/Reference.hpp>
 
+#import <Field/CellPacking.hpp>
+#import <Field/Checkpoint.hpp>
+#import <Field/RuleFile.hpp>
+
 #import <Graphics/BSpline.hpp>
 #import <Graphics/Jzazbz.hpp>
 #import <Graphics/Gamma.hpp>
@@ -31,6 +35,7 @@
 #import <Shaders/Data/AutomatRule.hpp>
 
 #import <numeric>
+#import <optional>
 
 //===------------------------------------------------------------------------===
 //
@@ -65,6 +70,9 @@ static_assert( data::is_trivial_layout<CompositionData>(), "Unexpected layout" )
     const AutomatRule*          rule;
 
     uint8_t                     substep;
+
+    std::optional<field::CheckpointCache>   checkpointCache;
+    field::CheckpointKey                    checkpointKey;
 }
 
 //===------------------------------------------------------------------------===
@@ -73,6 +81,13 @@ static_assert( data::is_trivial_layout<CompositionData>(), "Unexpected layout" )
 
 - (nullable instancetype)initWithDevice:(nonnull id<MTLDevice>)device {
 
+    return [self initWithDevice:device ruleFileURL:nil rank:0];
+}
+
+- (nullable instancetype)initWithDevice:(nonnull id<MTLDevice>)device
+                            ruleFileURL:(nullable NSURL *)ruleFileURL
+                                   rank:(NSUInteger)rank {
+
     self = [super init];
 
     if (nil != self) {
@@ -120,6 +135,16 @@ static_assert( data::is_trivial_layout<CompositionData>(), "Unexpected layout" )
             rule->survive          = 0b000011100;    // 2, 3, 4
             rule->growth_duration  = 0;
             rule->decline_duration = 19;
+            rule->radius           = 1;              // Moore
+            rule->boundary         = boundary_torus;
+            rule->born_min         = 0;
+            rule->born_max         = 0;
+            rule->survive_min      = 0;
+            rule->survive_max      = 0;
+            rule->born_chance      = 0;              // Deterministic
+            rule->survive_chance   = 0;
+            rule->seed             = 0;
+            rule->topology         = topology_moore;
 
             self->rule = rule;
 
@@ -196,12 +221,80 @@ static_assert( data::is_trivial_layout<CompositionData>(), "Unexpected layout" )
             };
 
             self->surface = surface;
+
+            // • Rule search result, replacing the initialization, rule and warm-up
+            //
+            if (nil != ruleFileURL) {
+
+                const auto rule_file = field::RuleFile(ruleFileURL.fileSystemRepresentation);
+
+                if (rule_file.size() <= rank) {
+                    return nil;
+                }
+
+                const auto& seed = rule_file.seed();
+
+                field_init->field_size  = { seed.field_width, seed.field_height };
+                field_init->offset      = { seed.offset_x, seed.offset_y };
+                field_init->count       = seed.count;
+                field_init->base_region = {
+                    .left   = seed.base_region.left,
+                    .top    = seed.base_region.top,
+                    .right  = seed.base_region.right,
+                    .bottom = seed.base_region.bottom
+                };
+
+                *rule             = rule_file[rank].rule;
+                _initialStepCount = rule_file.initial_step_count();
+            }
+
+            // • Warm-up checkpoint key: everything the field depends on until
+            //      the first visible frame
+            //
+            auto content = field::ContentHash{};
+
+            content << field_init->field_size  << field_init->base_region
+                    << field_init->offset      << field_init->count
+                    << rule->born              << rule->survive
+                    << rule->growth_duration   << rule->decline_duration
+                    << rule->radius            << rule->boundary
+                    << rule->born_min          << rule->born_max
+                    << rule->survive_min       << rule->survive_max
+                    << rule->born_chance       << rule->survive_chance
+                    << rule->seed              << rule->topology;
+
+            checkpointKey = {
+                .content    = content.value(),
+                .width      = field_init->field_size.x,
+                .height     = field_init->field_size.y,
+                .step_count = static_cast<uint32_t>(_initialStepCount)
+            };
         }
         catch ( ... )
         {
             return nil;
         }
 
+        // • Checkpoint cache (optional: warm-up runs every time without it)
+        //
+        NSURL *cachesURL = [NSFileManager.defaultManager URLsForDirectory:NSCachesDirectory
+                                                                inDomains:NSUserDomainMask].firstObject;
+        NSString *bundleID = NSBundle.mainBundle.bundleIdentifier;
+
+        if (nil != cachesURL && nil != bundleID) {
+
+            NSURL *checkpointURL = [[cachesURL URLByAppendingPathComponent:bundleID isDirectory:YES]
+                                               URLByAppendingPathComponent:@"Checkpoints" isDirectory:YES];
+            try
+            {
+                checkpointCache.emplace(checkpointURL.fileSystemRepresentation);
+            }
+            catch ( ... )
+            {
+                checkpointCache.reset();
+            }
+        }
+
         // • Aspect ratio
         //
         _aspectRatio = { 16, 9 };
@@ -252,6 +345,23 @@ static_assert( data::is_trivial_layout<CompositionData>(), "Unexpected layout" )
     return composition->rule.offset;
 }
 
+- (NSInteger)neighborhoodRadius {
+
+    return (1 < rule->radius) ? rule->radius : 1;
+}
+
+- (uint8_t)neighborhoodTopology {
+
+    return rule->topology;
+}
+
+- (MTLPixelFormat)fieldPixelFormat {
+
+    // • Packed cells: one byte while both durations fit in 7 bits
+    //
+    return (1 == field::packed_cell_size(*rule)) ? MTLPixelFormatR8Uint : MTLPixelFormatR16Uint;
+}
+
 //===------------------------------------------------------------------------===
 #pragma mark - Properties (Colorization)
 //===------------------------------------------------------------------------===
@@ -309,6 +419,11 @@ static_assert( data::is_trivial_layout<CompositionData>(), "Unexpected layout" )
     return substep;
 }
 
+- (uint8_t)stepDuration {
+
+    return colorization->step_duration;
+}
+
 //===------------------------------------------------------------------------===
 #pragma mark - Methods (State)
 //===------------------------------------------------------------------------===
@@ -318,4 +433,42 @@ static_assert( data::is_trivial_layout<CompositionData>(), "Unexpected layout" )
     substep = (substep + 1) % colorization->step_duration;
 }
 
+//===------------------------------------------------------------------------===
+#pragma mark - Methods (Field Checkpoint)
+//===------------------------------------------------------------------------===
+
+- (BOOL)loadFieldCheckpointIntoTexture:(nonnull id<MTLTexture>)fieldTexture {
+
+    if (!checkpointCache || 0 == _initialStepCount) {
+        return NO;
+    }
+
+    const auto checkpoint = checkpointCache->load(checkpointKey);
+
+    if (!checkpoint || checkpoint->cell_size() != field::packed_cell_size(*rule)) {
+        return NO;
+    }
+
+    [fieldTexture replaceRegion:MTLRegionMake2D(0, 0, checkpoint->width(), checkpoint->height())
+                    mipmapLevel:0
+                      withBytes:checkpoint->data()
+                    bytesPerRow:checkpoint->bytes_per_row()];
+    return YES;
+}
+
+- (void)storeFieldCheckpointFromBuffer:(nonnull id<MTLBuffer>)fieldBuffer {
+
+    if (!checkpointCache || 0 == _initialStepCount) {
+        return;
+    }
+
+    const auto cellSize = field::packed_cell_size(*rule);
+
+    if (fieldBuffer.length < size_t{ checkpointKey.width } * checkpointKey.height * cellSize) {
+        return;
+    }
+
+    checkpointCache->store(checkpointKey, fieldBuffer.contents, cellSize);
+}
+
 @end
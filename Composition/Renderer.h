@@ -53,6 +53,13 @@
 @property (nonnull, nonatomic, readonly) Composition *composition;
 @property (nonatomic, readonly) MTLPixelFormat fieldPixelFormat;
 
+// • Properties
+//
+//  Whether the next generation is stepped a slice of rows per substep
+//  rather than all at once on the last substep (default YES)
+//
+@property (nonatomic) BOOL stepsInSlices;
+
 // • Methods (RendererProtocol)
 //
 - (BOOL)prepareFrameOfSize:(simd_uint2)size
@@ -46,6 +46,8 @@
     BSplineSurface *bsplineSurface;
 
     StepField      *stepField;
+    uint64_t        generation;     // of fieldTextures[0], keying stochastic draws
+    NSUInteger      steppedRows;    // of fieldTextures[1], when stepping in slices
 }
 
 //===------------------------------------------------------------------------===
@@ -64,7 +66,7 @@
         _device           = library.device;
         _composition      = composition;
         _pixelFormat      = MTLPixelFormatRGBA16Float;
-        _fieldPixelFormat = MTLPixelFormatRGBA8Uint;
+        _fieldPixelFormat = composition.fieldPixelFormat;
 
         _colorspace = CGColorSpaceCreateWithName(kCGColorSpaceITUR_2020);
 
@@ -118,6 +120,8 @@
             return nil;
         }
 
+        _stepsInSlices = YES;
+
         // • Textures and resource initialization
         //
         if ( ![self finalInitWithCommandQueue:commandQueue] ) {
@@ -141,6 +145,13 @@
         _composition        = composition;
         _pixelFormat        = sourceRenderer.pixelFormat;
         _fieldPixelFormat   = sourceRenderer.fieldPixelFormat;
+
+        // • The field pipelines are shared, so the packed cell size must match
+        //
+        if (composition.fieldPixelFormat != _fieldPixelFormat) {
+            return nil;
+        }
+
         _colorspace         = CGColorSpaceRetain(sourceRenderer.colorspace);
 
         clearField          = sourceRenderer->clearField;
@@ -150,6 +161,7 @@
         fillBackground      = sourceRenderer->fillBackground;
         bsplineSurface      = sourceRenderer->bsplineSurface;
         stepField           = sourceRenderer->stepField;
+        _stepsInSlices      = sourceRenderer.stepsInSlices;
 
         // • Textures and resource initialization
         //
@@ -203,6 +215,16 @@
         return NO;
     }
 
+    // • Restore the warmed-up field when it has been checkpointed
+    //
+    if ([_composition loadFieldCheckpointIntoTexture:fieldTextures[0]]) {
+
+        generation = _composition.initialStepCount;
+        return YES;
+    }
+
+    generation = 0;
+
     // • Initialize resources
     //
     id<MTLCommandBuffer> commandBuffer = [commandQueue commandBuffer];
@@ -245,9 +267,11 @@
 
         if (nil != stepEncoder) {
 
+            const NSRange allRows = NSMakeRange(0, _composition.fieldSize.y);
+
             for (NSInteger ii = 0; ii < _composition.initialStepCount; ++ii) {
 
-                [self stepWithEncoder:stepEncoder];
+                [self stepRows:allRows withEncoder:stepEncoder];
             }
 
             [stepEncoder endEncoding];
@@ -257,6 +281,42 @@
         }
     }
 
+    // • Checkpoint the warmed-up field once the steps have completed
+    //
+    if (success && 0 < _composition.initialStepCount) {
+
+        const NSUInteger cellSize    = (MTLPixelFormatR8Uint == _fieldPixelFormat) ? 1 : 2;
+        const NSUInteger bytesPerRow = cellSize * _composition.fieldSize.x;
+
+        id<MTLBuffer> checkpointBuffer = [_device newBufferWithLength:bytesPerRow * _composition.fieldSize.y
+                                                              options:MTLResourceStorageModeShared];
+        id<MTLBlitCommandEncoder> blitEncoder = [commandBuffer blitCommandEncoder];
+
+        if (nil != checkpointBuffer && nil != blitEncoder) {
+
+            [blitEncoder copyFromTexture:fieldTextures[0]
+                             sourceSlice:0
+                             sourceLevel:0
+                            sourceOrigin:MTLOriginMake(0, 0, 0)
+                              sourceSize:MTLSizeMake(_composition.fieldSize.x, _composition.fieldSize.y, 1)
+                                toBuffer:checkpointBuffer
+                       destinationOffset:0
+                  destinationBytesPerRow:bytesPerRow
+                destinationBytesPerImage:bytesPerRow * _composition.fieldSize.y];
+
+            Composition *composition = _composition;
+
+            [commandBuffer addCompletedHandler:^(id<MTLCommandBuffer> completedBuffer) {
+
+                if (MTLCommandBufferStatusCompleted == completedBuffer.status) {
+                    [composition storeFieldCheckpointFromBuffer:checkpointBuffer];
+                }
+            }];
+        }
+
+        [blitEncoder endEncoding];
+    }
+
     if (nil != commandBuffer) {
         [commandBuffer commit];
     }
@@ -293,6 +353,7 @@
                             fromBuffer:_composition.colorizeFieldBuffer
                               atOffset:_composition.colorizeFieldOffset
                         currentSubstep:_composition.currentSubstep
+                            ruleOffset:_composition.ruleOffset
                           fieldTexture:fieldTextures[0]
                  colorizedFieldTexture:colorizedFieldTexture];
 
@@ -318,7 +379,9 @@
 
 - (BOOL)nextFrameWithCommandBuffer:(nonnull id<MTLCommandBuffer>)commandBuffer {
 
-    if (_composition.shouldStepNext) {
+    const NSRange rows = [self nextStepRows];
+
+    if (0 < rows.length) {
 
         id<MTLComputeCommandEncoder> stepEncoder = [commandBuffer computeCommandEncoder];
 
@@ -326,7 +389,7 @@
             return NO;
         }
 
-        [self stepWithEncoder:stepEncoder];
+        [self stepRows:rows withEncoder:stepEncoder];
         [stepEncoder endEncoding];
     }
 
@@ -340,13 +403,58 @@
 #pragma mark - Private Methods
 //===------------------------------------------------------------------------===
 
-- (void)stepWithEncoder:(nonnull id<MTLComputeCommandEncoder>)stepEncoder {
+// • The rows of the next generation still to be stepped this substep. When
+//      stepping in slices each substep steps its share of the 32 row bands
+//      into fieldTextures[1], leaving fieldTextures[0] to be colorized;
+//      otherwise the whole field is stepped on the last substep.
+//
+- (NSRange)nextStepRows {
+
+    const NSUInteger height = _composition.fieldSize.y;
+    NSUInteger       end    = 0;
+
+    if (_composition.shouldStepNext) {
+
+        end = height;
+
+    } else if (_stepsInSlices) {
+
+        const NSUInteger bands = (height + 31) / 32;
+        const NSUInteger due   = bands * (_composition.currentSubstep + 1) / _composition.stepDuration;
+
+        end = MIN(32 * due, height);
+    }
+
+    // • Slices already stepped before slicing was turned off are kept
+    //
+    end = MAX(end, steppedRows);
+
+    return NSMakeRange(steppedRows, end - steppedRows);
+}
+
+// • Steps rows of fieldTextures[0] into fieldTextures[1], swapping them once
+//      the whole of the next generation has been written
+//
+- (void)stepRows:(NSRange)rows withEncoder:(nonnull id<MTLComputeCommandEncoder>)stepEncoder {
 
     [stepField dispatchWithEncoder:stepEncoder
                         fromBuffer:_composition.ruleBuffer
                           atOffset:_composition.ruleOffset
                 sourceFieldTexture:fieldTextures[0]
-           destinationFieldTexture:fieldTextures[1]];
+           destinationFieldTexture:fieldTextures[1]
+                neighborhoodRadius:_composition.neighborhoodRadius
+              neighborhoodTopology:_composition.neighborhoodTopology
+                        generation:generation
+                              rows:rows];
+
+    steppedRows = NSMaxRange(rows);
+
+    if (steppedRows < _composition.fieldSize.y) {
+        return;
+    }
+
+    steppedRows = 0;
+    ++generation;
 
     id<MTLTexture> temp = fieldTextures[0];
     fieldTextures[0] = fieldTextures[1];
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <type_traits>
 
 //===------------------------------------------------------------------------===
@@ -0,0 +1,338 @@
+//
+//  BatchStepper.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/BatchStepper.hpp>
+#include <Field/BitSlice.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <bit>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+BatchStepper::BatchStepper(uint32_t width, uint32_t height, uint32_t worker_count) noexcept(false)
+    :
+        m_width       { width      },
+        m_height      { height     },
+        m_alive_stride{ width + 2u },
+        m_current     { 0 },
+        m_step_bits   { 0 },
+        m_generation  { 0 },
+        m_born        {   },
+        m_survive     {   },
+        m_growth      {   },
+        m_decline     {   },
+        m_counts      { 0 },
+        m_pool        { worker_count }
+{
+    if ( 0 == width || 0 == height ) {
+        throw false;
+    }
+
+    const auto alive_size = size_t{ m_alive_stride } * (height + 2u);
+
+    m_alive[0].assign( alive_size, 0 );
+    m_alive[1].assign( alive_size, 0 );
+    m_step.assign    ( size_t{ 8 } * width * height, 0 );
+
+    m_rules.reserve(lane_count);
+    m_stats.reserve(lane_count);
+    m_tallies.resize( m_pool.worker_count() );
+}
+
+//===------------------------------------------------------------------------===
+// • Methods
+//===------------------------------------------------------------------------===
+
+uint32_t BatchStepper::add(const AutomatRule& rule, const Grid& seed) noexcept(false)
+{
+    if ( lane_count <= m_rules.size() || seed.width() != m_width || seed.height() != m_height
+      || is_larger_than_life(rule) || !is_moore(rule) || !is_torus(rule) || is_stochastic(rule) )
+    {
+        throw false;
+    }
+
+    const auto lane = static_cast<uint32_t>( m_rules.size() );
+    const auto bit  = uint64_t{ 1 } << lane;
+
+    // • Rule masks
+    //
+    for ( auto count = uint32_t{ 0 }; count <= 8u; ++count )
+    {
+        if ( is_born(rule, count) ) {
+            m_born[count] |= bit;
+        }
+
+        if ( survives(rule, count) ) {
+            m_survive[count] |= bit;
+        }
+    }
+
+    m_counts |= (rule.born | rule.survive) & 0x1ffu;
+
+    for ( auto b = uint32_t{ 0 }; b < 8u; ++b )
+    {
+        if ( rule.growth_duration & (1u << b) ) {
+            m_growth[b] |= bit;
+        }
+
+        if ( rule.decline_duration & (1u << b) ) {
+            m_decline[b] |= bit;
+        }
+    }
+
+    auto step_bits = static_cast<uint32_t>( std::bit_width( std::max(rule.growth_duration, rule.decline_duration) ) );
+
+    // • Seed
+    //
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto* row   = seed.row(y);
+        auto*       alive = alive_row(m_current, y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            const auto index = size_t{ y } * m_width + x;
+
+            if ( row[x].alive ) {
+                alive[x] |= bit;
+            }
+
+            for ( auto b = uint32_t{ 0 }; b < 8u; ++b )
+            {
+                if ( row[x].step & (1u << b) ) {
+                    step_plane(b)[index] |= bit;
+                }
+            }
+
+            step_bits = std::max( step_bits, static_cast<uint32_t>( std::bit_width(row[x].step) ) );
+        }
+    }
+
+    m_step_bits = std::max(m_step_bits, step_bits);
+
+    m_rules.push_back(rule);
+    m_stats.push_back( BatchStats{} );
+
+    return lane;
+}
+
+void BatchStepper::store(uint32_t variant, Grid& grid) const noexcept(false)
+{
+    if ( variant_count() <= variant || grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    const auto& rule = m_rules[variant];
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto* alive = alive_row(m_current, y);
+        auto*       row   = grid.row(y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            const auto index = size_t{ y } * m_width + x;
+            auto       step  = uint32_t{ 0 };
+
+            for ( auto b = uint32_t{ 0 }; b < m_step_bits; ++b ) {
+                step |= static_cast<uint32_t>( (step_plane(b)[index] >> variant) & 1u ) << b;
+            }
+
+            const auto is_alive = 0 != ( (alive[x] >> variant) & 1u );
+
+            row[x] = FieldValue {
+                .alive    = static_cast<uint8_t>( is_alive ),
+                .step     = static_cast<uint8_t>( step ),
+                .duration = ( 0 == step ) ? uint8_t{ 0 }
+                          : is_alive      ? rule.growth_duration
+                          :                 rule.decline_duration,
+                .reserved = 0
+            };
+        }
+    }
+}
+
+void BatchStepper::clear(void) noexcept
+{
+    std::fill( m_alive[0].begin(), m_alive[0].end(), uint64_t{ 0 } );
+    std::fill( m_alive[1].begin(), m_alive[1].end(), uint64_t{ 0 } );
+    std::fill( m_step.begin(),     m_step.end(),     uint64_t{ 0 } );
+
+    m_born    = {};
+    m_survive = {};
+    m_growth  = {};
+    m_decline = {};
+
+    m_counts     = 0;
+    m_step_bits  = 0;
+    m_generation = 0;
+
+    m_rules.clear();
+    m_stats.clear();
+}
+
+void BatchStepper::count_adjacent(std::vector<uint64_t>& pairs) const noexcept(false)
+{
+    auto east  = LaneCounter{};
+    auto south = LaneCounter{};
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto* row   = alive_row(m_current, y);
+        const auto* below = alive_row(m_current, (y + 1u) % m_height);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            east.add ( row[x] & row[(x + 1u) % m_width] );
+            south.add( row[x] & below[x] );
+        }
+    }
+
+    pairs.resize( variant_count() );
+
+    for ( auto lane = uint32_t{ 0 }; lane < variant_count(); ++lane ) {
+        pairs[lane] = east.count(lane) + south.count(lane);
+    }
+}
+
+void BatchStepper::step(void) noexcept
+{
+    update_ghost_ring();
+
+    m_pool.run(m_height, [&](uint32_t worker, uint32_t y) {
+        step_row(y, m_tallies[worker]);
+    });
+
+    // • Spread the tallies out into per-variant totals
+    //
+    for ( auto lane = uint32_t{ 0 }; lane < variant_count(); ++lane )
+    {
+        auto& stats = m_stats[lane];
+
+        stats = BatchStats{};
+
+        for ( const auto& tally : m_tallies )
+        {
+            stats.population += tally.population.count(lane);
+            stats.growth     += tally.growth.count(lane);
+            stats.decline    += tally.decline.count(lane);
+        }
+    }
+
+    for ( auto& tally : m_tallies ) {
+        tally = Tally{};
+    }
+
+    m_current ^= 1u;
+    ++m_generation;
+}
+
+//===------------------------------------------------------------------------===
+// • Private Methods
+//===------------------------------------------------------------------------===
+
+void BatchStepper::update_ghost_ring(void) noexcept
+{
+    auto& alive = m_alive[m_current];
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        auto* row = alive_row(m_current, y);
+
+        row[-1]      = row[m_width - 1u];
+        row[m_width] = row[0];
+    }
+
+    std::copy_n( alive_row(m_current, m_height - 1u) - 1, m_alive_stride, alive.data() );
+    std::copy_n( alive_row(m_current, 0) - 1, m_alive_stride,
+                 alive.data() + size_t{ m_height + 1u } * m_alive_stride );
+}
+
+void BatchStepper::step_row(uint32_t y, Tally& tally) noexcept
+{
+    // • Windows from one column left of each cell
+    //
+    const auto* m    = alive_row(m_current, y) - 1;
+    const auto* u    = m - m_alive_stride;
+    const auto* l    = m + m_alive_stride;
+    auto*       next = alive_row(m_current ^ 1u, y);
+    const auto  base = size_t{ y } * m_width;
+
+    for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+    {
+        const auto n = count_neighbors( u[x], u[x + 1], u[x + 2],
+                                        m[x],           m[x + 2],
+                                        l[x], l[x + 1], l[x + 2] );
+
+        // • Lanes whose rule is born or survives on their own count
+        //
+        auto born    = uint64_t{ 0 };
+        auto survive = uint64_t{ 0 };
+
+        for ( auto remaining = m_counts; 0 != remaining; remaining &= remaining - 1u )
+        {
+            const auto count = static_cast<uint32_t>( std::countr_zero(remaining) );
+            const auto match = equals(n, count);
+
+            born    |= match & m_born[count];
+            survive |= match & m_survive[count];
+        }
+
+        // • Busy lanes count down, settled ones may transition
+        //
+        auto busy = uint64_t{ 0 };
+
+        for ( auto b = uint32_t{ 0 }; b < m_step_bits; ++b ) {
+            busy |= step_plane(b)[base + x];
+        }
+
+        const auto alive   = m[x + 1];
+        const auto decline = ~busy &  alive & ~survive;
+        const auto growth  = ~busy & ~alive &  born;
+
+        auto borrow = busy;
+
+        for ( auto b = uint32_t{ 0 }; b < m_step_bits; ++b )
+        {
+            auto&      plane = step_plane(b)[base + x];
+            const auto step  = plane;
+
+            plane  = (step ^ borrow) | (decline & m_decline[b]) | (growth & m_growth[b]);
+            borrow = borrow & ~step;
+        }
+
+        next[x] = (alive & ~decline) | growth;
+
+        tally.population.add(next[x]);
+        tally.growth.add(growth);
+        tally.decline.add(decline);
+    }
+}
+
+} // namespace field
@@ -0,0 +1,221 @@
+//
+//  BatchStepper.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/WorkerPool.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <array>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • BatchStats
+//
+//  Cells of one variant after the last step: alive, and those that started
+//  growing or declining during it
+//===------------------------------------------------------------------------===
+
+struct BatchStats
+{
+    uint64_t    population;
+    uint64_t    growth;
+    uint64_t    decline;
+};
+
+//===------------------------------------------------------------------------===
+//
+// • BatchStepper
+//
+//  Up to 64 independent variants of one field size, each with its own rule
+//  and seed, stepped together. Every cell is a set of 64-bit words whose
+//  bit i belongs to variant i: one alive word and one word per bit of the
+//  step count. Neighbor counts come from the bit-sliced adders of Bitboard
+//  applied to the eight neighboring words, so every variant is counted at
+//  once, and born, survive and the durations become per-lane word masks.
+//  One pass over memory steps every variant.
+//
+//  Stats are tallied with bit-sliced counters and only spread out into
+//  per-variant totals once per step. Durations are not kept: a stored cell
+//  that is counting down gets its rule's duration for its state, like an
+//  unpacked cell, and a settled one gets zero.
+//
+//  Moore neighborhood, torus boundary and deterministic rules only. Rows are
+//  stepped in parallel on a WorkerPool.
+//
+//===------------------------------------------------------------------------===
+
+class BatchStepper
+{
+public:
+
+    // • Constants
+    //
+    static constexpr uint32_t lane_count = 64;
+
+    // • Initialization (0 workers = one per hardware thread)
+    //
+    BatchStepper(uint32_t width, uint32_t height, uint32_t worker_count = 0) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    constexpr uint64_t generation(void) const noexcept
+    {
+        return m_generation;
+    }
+
+    uint32_t variant_count(void) const noexcept
+    {
+        return static_cast<uint32_t>( m_rules.size() );
+    }
+
+    const AutomatRule& rule(uint32_t variant) const noexcept
+    {
+        return m_rules[variant];
+    }
+
+    const BatchStats& stats(uint32_t variant) const noexcept
+    {
+        return m_stats[variant];
+    }
+
+    // • Methods : variants (add throws when full, for a seed of another size,
+    //      or for a Larger than Life, non-Moore, bounded or stochastic rule)
+    //
+    uint32_t add(const AutomatRule& rule, const Grid& seed) noexcept(false);
+    void     store(uint32_t variant, Grid& grid) const noexcept(false);
+    void     clear(void) noexcept;
+
+    // • Methods : pairs of adjacent alive cells of each variant, east and
+    //      south of every cell
+    //
+    void count_adjacent(std::vector<uint64_t>& pairs) const noexcept(false);
+
+    // • Methods : step
+    //
+    void step(void) noexcept;
+
+private:
+
+    // • Bit-sliced tallies (private)
+    //
+    struct LaneCounter
+    {
+        uint64_t    planes[32];     // bit p of lane i's count in bit i of planes[p]
+
+        void add(uint64_t lanes) noexcept
+        {
+            for ( auto p = 0; 0 != lanes; ++p )
+            {
+                const auto carry = planes[p] & lanes;
+
+                planes[p] ^= lanes;
+                lanes      = carry;
+            }
+        }
+
+        uint64_t count(uint32_t lane) const noexcept
+        {
+            auto total = uint64_t{ 0 };
+
+            for ( auto p = 0u; p < 32u; ++p ) {
+                total |= ( (planes[p] >> lane) & 1u ) << p;
+            }
+
+            return total;
+        }
+    };
+
+    struct alignas(64) Tally
+    {
+        LaneCounter population;
+        LaneCounter growth;
+        LaneCounter decline;
+    };
+
+    uint64_t* alive_row(uint32_t buffer, uint32_t y) noexcept
+    {
+        return m_alive[buffer].data() + size_t{ y + 1u } * m_alive_stride + 1u;
+    }
+
+    const uint64_t* alive_row(uint32_t buffer, uint32_t y) const noexcept
+    {
+        return m_alive[buffer].data() + size_t{ y + 1u } * m_alive_stride + 1u;
+    }
+
+    uint64_t* step_plane(uint32_t bit) noexcept
+    {
+        return m_step.data() + size_t{ bit } * m_width * m_height;
+    }
+
+    const uint64_t* step_plane(uint32_t bit) const noexcept
+    {
+        return m_step.data() + size_t{ bit } * m_width * m_height;
+    }
+
+    void update_ghost_ring(void) noexcept;
+    void step_row(uint32_t y, Tally& tally) noexcept;
+
+    // • Data members
+    //
+    uint32_t                    m_width;
+    uint32_t                    m_height;
+    uint32_t                    m_alive_stride;     // width plus two ghost columns
+    uint32_t                    m_current;
+    uint32_t                    m_step_bits;        // step planes in use
+    uint64_t                    m_generation;
+
+    std::vector<AutomatRule>    m_rules;
+    std::vector<BatchStats>     m_stats;
+
+    // • Per-lane rule masks: bit i of born[n] is set when variant i is born
+    //      on n neighbors, bit i of growth[b] is bit b of its growth duration
+    //
+    std::array<uint64_t, 9>     m_born;
+    std::array<uint64_t, 9>     m_survive;
+    std::array<uint64_t, 8>     m_growth;
+    std::array<uint64_t, 8>     m_decline;
+    uint32_t                    m_counts;           // neighbor counts any lane matches
+
+    std::vector<uint64_t>       m_alive[2];         // ghost ring of one cell
+    std::vector<uint64_t>       m_step;             // 8 planes of width * height
+
+    WorkerPool                  m_pool;
+    std::vector<Tally>          m_tallies;          // one per worker
+};
+
+} // namespace field
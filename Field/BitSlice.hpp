@@ -0,0 +1,95 @@
+//
+//  BitSlice.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstdint>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Bit-sliced neighbor count
+//
+//  Four bit planes (weights 1, 2, 4, 8) holding the 0...8 neighbor count of
+//  each of the 64 cells (or lanes) of a word
+//===------------------------------------------------------------------------===
+
+struct NeighborCount
+{
+    uint64_t    s0, s1, s2, s3;
+};
+
+constexpr void half_add(uint64_t a, uint64_t b, uint64_t& sum, uint64_t& carry) noexcept
+{
+    sum   = a ^ b;
+    carry = a & b;
+}
+
+constexpr void full_add(uint64_t a, uint64_t b, uint64_t c, uint64_t& sum, uint64_t& carry) noexcept
+{
+    const auto t = a ^ b;
+
+    sum   = t ^ c;
+    carry = (a & b) | (t & c);
+}
+
+constexpr NeighborCount count_neighbors( uint64_t uw, uint64_t u, uint64_t ue,
+                                         uint64_t mw,             uint64_t me,
+                                         uint64_t lw, uint64_t l, uint64_t le ) noexcept
+{
+    // • Column sums of each row (weights 1 and 2)
+    //
+    uint64_t su, cu, sm, cm, sl, cl;
+
+    full_add(uw, u, ue, su, cu);
+    half_add(mw, me,    sm, cm);
+    full_add(lw, l, le, sl, cl);
+
+    // • Ones
+    //
+    uint64_t s0, c0;
+
+    full_add(su, sm, sl, s0, c0);
+
+    // • Twos (four inputs of weight 2)
+    //
+    uint64_t t, c1, s1, c2;
+
+    full_add(cu, cm, cl, t, c1);
+    half_add(t, c0,      s1, c2);
+
+    // • Fours and eights
+    //
+    return { s0, s1, c1 ^ c2, c1 & c2 };
+}
+
+constexpr uint64_t equals(const NeighborCount& n, uint32_t count) noexcept
+{
+    return ( (count & 1u) ? n.s0 : ~n.s0 )
+         & ( (count & 2u) ? n.s1 : ~n.s1 )
+         & ( (count & 4u) ? n.s2 : ~n.s2 )
+         & ( (count & 8u) ? n.s3 : ~n.s3 );
+}
+
+} // namespace field
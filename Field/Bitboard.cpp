@@ -0,0 +1,246 @@
+//
+//  Bitboard.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/Bitboard.hpp>
+#include <Field/BitSlice.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <bit>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+Bitboard::Bitboard(uint32_t width, uint32_t height) noexcept(false)
+    :
+        m_width        { width  },
+        m_height       { height },
+        m_words_per_row{ (width + 63u) / 64u },
+        m_tail_mask    { ~uint64_t{ 0 } >> ( (64u - width % 64u) % 64u ) }
+{
+    if ( 0 == width || 0 == height ) {
+        throw false;
+    }
+
+    const auto word_count = size_t{ m_words_per_row } * height;
+    const auto cell_count = size_t{ width } * height;
+
+    m_alive.assign     ( word_count, 0 );
+    m_next_alive.assign( word_count, 0 );
+    m_busy.assign      ( word_count, 0 );
+    m_step.assign      ( cell_count, 0 );
+    m_duration.assign  ( cell_count, 0 );
+}
+
+//===------------------------------------------------------------------------===
+// • Accessors
+//===------------------------------------------------------------------------===
+
+FieldValue Bitboard::value(uint32_t x, uint32_t y) const noexcept
+{
+    assert( x < m_width && y < m_height );
+
+    const auto word  = alive_row(y)[x / 64u];
+    const auto index = size_t{ y } * m_width + x;
+
+    return {
+        .alive    = static_cast<uint8_t>( (word >> (x % 64u)) & 1u ),
+        .step     = m_step[index],
+        .duration = m_duration[index],
+        .reserved = 0
+    };
+}
+
+//===------------------------------------------------------------------------===
+// • Transfer
+//===------------------------------------------------------------------------===
+
+void Bitboard::load(const Grid& grid) noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto src   = grid.row(y);
+        auto       alive = m_alive.data() + size_t{ y } * m_words_per_row;
+        auto       busy  = m_busy.data()  + size_t{ y } * m_words_per_row;
+
+        std::fill_n( alive, m_words_per_row, 0 );
+        std::fill_n( busy,  m_words_per_row, 0 );
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            const auto bit   = uint64_t{ 1 } << (x % 64u);
+            const auto index = size_t{ y } * m_width + x;
+
+            if ( src[x].alive ) {
+                alive[x / 64u] |= bit;
+            }
+
+            if ( 0 < src[x].step ) {
+                busy[x / 64u] |= bit;
+            }
+
+            m_step[index]     = src[x].step;
+            m_duration[index] = src[x].duration;
+        }
+    }
+}
+
+void Bitboard::store(Grid& grid) const noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        auto dest = grid.row(y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            dest[x] = value(x, y);
+        }
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Step
+//===------------------------------------------------------------------------===
+
+void Bitboard::step(const AutomatRule& rule) noexcept
+{
+    assert( !is_larger_than_life(rule) && is_moore(rule) && is_torus(rule) && !is_stochastic(rule) );
+
+    const auto last_word = m_words_per_row - 1u;
+    const auto last_bit  = (m_width - 1u) % 64u;
+
+    // • Horizontal neighbors with toroidal wrap. West is the word whose bit i
+    //      holds cell x - 1, east holds cell x + 1
+    //
+    const auto west = [&](const uint64_t* row, uint32_t j) noexcept
+    {
+        const auto carry = ( 0 < j ) ? row[j - 1] >> 63 : (row[last_word] >> last_bit) & 1u;
+
+        return (row[j] << 1) | carry;
+    };
+
+    const auto east = [&](const uint64_t* row, uint32_t j) noexcept
+    {
+        return ( j < last_word )
+            ? (row[j] >> 1) | ( (row[j + 1] & 1u) << 63 )
+            : (row[j] >> 1) | ( (row[0] & 1u) << last_bit );
+    };
+
+    // • Only counts that either mask can match are ever decoded
+    //
+    const auto counts = static_cast<uint32_t>( (rule.born | rule.survive) & 0x1ffu );
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto upper  = alive_row( (y + m_height - 1u) % m_height );
+        const auto middle = alive_row( y );
+        const auto lower  = alive_row( (y + 1u) % m_height );
+
+        const auto row_offset = size_t{ y } * m_words_per_row;
+
+        auto next_alive = m_next_alive.data() + row_offset;
+        auto busy       = m_busy.data()       + row_offset;
+
+        for ( auto j = uint32_t{ 0 }; j < m_words_per_row; ++j )
+        {
+            const auto valid = ( j < last_word ) ? ~uint64_t{ 0 } : m_tail_mask;
+
+            // • Neighbor counts and rule masks
+            //
+            const auto n = count_neighbors( west(upper, j),  upper[j], east(upper, j),
+                                            west(middle, j),           east(middle, j),
+                                            west(lower, j),  lower[j], east(lower, j) );
+
+            auto born    = uint64_t{ 0 };
+            auto survive = uint64_t{ 0 };
+
+            for ( auto remaining = counts; 0 != remaining; remaining &= remaining - 1u )
+            {
+                const auto count = static_cast<uint32_t>( std::countr_zero(remaining) );
+                const auto match = equals(n, count);
+
+                if ( rule.born    & (1u << count) ) born    |= match;
+                if ( rule.survive & (1u << count) ) survive |= match;
+            }
+
+            // • Transitions only start from cells that have finished stepping
+            //
+            const auto alive    = middle[j];
+            const auto settled  = ~busy[j] & valid;
+            const auto growth   = settled & ~alive & born;
+            const auto decline  = settled &  alive & ~survive;
+
+            next_alive[j] = alive ^ (growth | decline);
+
+            // • Step and duration planes, touching only cells in transition
+            //
+            const auto cell_base = size_t{ y } * m_width + size_t{ j } * 64u;
+
+            auto next_busy = busy[j];
+
+            for ( auto bits = busy[j]; 0 != bits; bits &= bits - 1u )
+            {
+                const auto index = cell_base + std::countr_zero(bits);
+
+                if ( 0 == --m_step[index] ) {
+                    next_busy &= ~(bits & -bits);
+                }
+            }
+
+            for ( auto bits = growth; 0 != bits; bits &= bits - 1u )
+            {
+                const auto index = cell_base + std::countr_zero(bits);
+
+                m_step[index] = m_duration[index] = rule.growth_duration;
+            }
+
+            for ( auto bits = decline; 0 != bits; bits &= bits - 1u )
+            {
+                const auto index = cell_base + std::countr_zero(bits);
+
+                m_step[index] = m_duration[index] = rule.decline_duration;
+            }
+
+            if ( 0 < rule.growth_duration ) next_busy |= growth;
+            if ( 0 < rule.decline_duration ) next_busy |= decline;
+
+            busy[j] = next_busy;
+        }
+    }
+
+    m_alive.swap(m_next_alive);
+}
+
+} // namespace field
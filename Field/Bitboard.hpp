@@ -0,0 +1,113 @@
+//
+//  Bitboard.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+//
+// • Bitboard
+//
+//  Toroidal field stepped 64 cells at a time. The alive plane is packed into
+//  64-bit words (bit i of word j is cell 64j + i) and neighbor counts are
+//  produced with bit-sliced adders, so born/survive apply as word masks.
+//
+//  The step and duration planes are kept separately, one byte per cell, and
+//  are only written for cells in transition. A busy plane (step > 0) marks
+//  those cells so that settled words never touch the byte planes.
+//
+//===------------------------------------------------------------------------===
+
+class Bitboard
+{
+public:
+
+    // • Initialization
+    //
+    Bitboard(uint32_t width, uint32_t height) noexcept(false);
+
+    // • Accessors : dimensions
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    constexpr uint32_t words_per_row(void) const noexcept
+    {
+        return m_words_per_row;
+    }
+
+    // • Accessors : planes
+    //
+    const uint64_t* alive_row(uint32_t y) const noexcept
+    {
+        return m_alive.data() + size_t{ y } * m_words_per_row;
+    }
+
+    const uint64_t* busy_row(uint32_t y) const noexcept
+    {
+        return m_busy.data() + size_t{ y } * m_words_per_row;
+    }
+
+    FieldValue value(uint32_t x, uint32_t y) const noexcept;
+
+    // • Methods : transfer
+    //
+    void load(const Grid& grid) noexcept(false);
+    void store(Grid& grid) const noexcept(false);
+
+    // • Methods : step (Moore neighborhood, torus boundary and deterministic
+    //      rules only)
+    //
+    void step(const AutomatRule& rule) noexcept;
+
+private:
+
+    // • Data members
+    //
+    uint32_t                m_width;
+    uint32_t                m_height;
+    uint32_t                m_words_per_row;
+    uint64_t                m_tail_mask;        // Valid bits of the last word in a row
+
+    std::vector<uint64_t>   m_alive;
+    std::vector<uint64_t>   m_next_alive;
+    std::vector<uint64_t>   m_busy;             // step > 0
+    std::vector<uint8_t>    m_step;
+    std::vector<uint8_t>    m_duration;
+};
+
+} // namespace field
@@ -0,0 +1,404 @@
+//
+//  BlockedGrid.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/Step.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+#include <Shaders/Data/FieldValue.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Morton order
+//===------------------------------------------------------------------------===
+
+constexpr uint64_t spread_bits(uint32_t value) noexcept
+{
+    auto bits = uint64_t{ value };
+
+    bits = ( bits | (bits << 16) ) & 0x0000ffff0000ffff;
+    bits = ( bits | (bits <<  8) ) & 0x00ff00ff00ff00ff;
+    bits = ( bits | (bits <<  4) ) & 0x0f0f0f0f0f0f0f0f;
+    bits = ( bits | (bits <<  2) ) & 0x3333333333333333;
+    bits = ( bits | (bits <<  1) ) & 0x5555555555555555;
+
+    return bits;
+}
+
+constexpr uint64_t morton_code(uint32_t x, uint32_t y) noexcept
+{
+    return spread_bits(x) | ( spread_bits(y) << 1 );
+}
+
+//===------------------------------------------------------------------------===
+//
+// • BlockedGrid
+//
+//  Field stored as TileSide_ x TileSide_ tiles, each contiguous and
+//  row-major, with the tiles in Z-order. A cell's stencil lies within its
+//  own tile and the tiles beside it, which the Z-order keeps close in
+//  memory, instead of in rows a full field width apart. Edge tiles are
+//  padded to the full tile size; padding cells are zero and never stepped.
+//
+//  The accessors match Grid's, so code written against at() and wrapped()
+//  works with either layout. tile_row() is the fast path: the run of a row
+//  that lies in one tile.
+//
+//===------------------------------------------------------------------------===
+
+template <uint32_t TileSide_>
+class BlockedGrid
+{
+    static_assert( std::has_single_bit(TileSide_) && 4u <= TileSide_ && TileSide_ <= 64u,
+                   "Tile side must be a power of two from 4 to 64" );
+
+public:
+
+    // • Constants
+    //
+    static constexpr uint32_t tile_side  = TileSide_;
+    static constexpr uint32_t tile_shift = std::countr_zero(TileSide_);
+    static constexpr uint32_t tile_mask  = TileSide_ - 1u;
+    static constexpr size_t   tile_cells = size_t{ TileSide_ } * TileSide_;
+
+    // • Initialization
+    //
+    BlockedGrid(uint32_t width, uint32_t height) noexcept(false)
+        :
+            m_width  { width                                   },
+            m_height { height                                  },
+            m_tiles_x{ (width  + tile_mask) >> tile_shift      },
+            m_tiles_y{ (height + tile_mask) >> tile_shift      }
+    {
+        if ( 0 == width || 0 == height ) {
+            throw false;
+        }
+
+        const auto tile_count = size_t{ m_tiles_x } * m_tiles_y;
+
+        // • Storage order: tiles sorted by the Morton code of their
+        //      coordinates, which for a tile grid that is not a square power
+        //      of two simply skips the codes that have no tile
+        //
+        m_tile_order.resize(tile_count);
+        std::iota(m_tile_order.begin(), m_tile_order.end(), uint32_t{ 0 });
+
+        std::sort(m_tile_order.begin(), m_tile_order.end(), [this](uint32_t lhs, uint32_t rhs) noexcept {
+            return morton_code(lhs % m_tiles_x, lhs / m_tiles_x) < morton_code(rhs % m_tiles_x, rhs / m_tiles_x);
+        });
+
+        m_tile_slots.resize(tile_count);
+
+        for ( auto slot = uint32_t{ 0 }; slot < tile_count; ++slot ) {
+            m_tile_slots[ m_tile_order[slot] ] = slot;
+        }
+
+        m_values.assign( tile_count * tile_cells, FieldValue{ 0, 0, 0, 0 } );
+    }
+
+    explicit BlockedGrid(const Grid& grid) noexcept(false)
+        :
+            BlockedGrid{ grid.width(), grid.height() }
+    {
+        load(grid);
+    }
+
+    // • Comparison
+    //
+    bool operator == (const BlockedGrid& ) const noexcept = default;
+
+    // • Accessors : dimensions
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    constexpr uint32_t tiles_x(void) const noexcept
+    {
+        return m_tiles_x;
+    }
+
+    constexpr uint32_t tiles_y(void) const noexcept
+    {
+        return m_tiles_y;
+    }
+
+    size_t tile_count(void) const noexcept
+    {
+        return m_tile_order.size();
+    }
+
+    // • Accessors : tiles in storage order
+    //
+    struct TileOrigin
+    {
+        uint32_t    x;
+        uint32_t    y;
+    };
+
+    TileOrigin tile_origin(size_t slot) const noexcept
+    {
+        const auto tile = m_tile_order[slot];
+
+        return { (tile % m_tiles_x) << tile_shift, (tile / m_tiles_x) << tile_shift };
+    }
+
+    FieldValue* tile(size_t slot) noexcept
+    {
+        return m_values.data() + slot * tile_cells;
+    }
+
+    const FieldValue* tile(size_t slot) const noexcept
+    {
+        return m_values.data() + slot * tile_cells;
+    }
+
+    // • Accessors : values
+    //
+    size_t index(uint32_t x, uint32_t y) const noexcept
+    {
+        assert( x < m_width && y < m_height );
+
+        const auto slot = m_tile_slots[ size_t{ y >> tile_shift } * m_tiles_x + (x >> tile_shift) ];
+
+        return slot * tile_cells + ( (y & tile_mask) << tile_shift ) + (x & tile_mask);
+    }
+
+    FieldValue& at(uint32_t x, uint32_t y) noexcept
+    {
+        return m_values[ index(x, y) ];
+    }
+
+    const FieldValue& at(uint32_t x, uint32_t y) const noexcept
+    {
+        return m_values[ index(x, y) ];
+    }
+
+    // • Accessors : the cells of row y from x to the end of x's tile
+    //
+    FieldValue* tile_row(uint32_t x, uint32_t y) noexcept
+    {
+        return m_values.data() + index(x, y);
+    }
+
+    const FieldValue* tile_row(uint32_t x, uint32_t y) const noexcept
+    {
+        return m_values.data() + index(x, y);
+    }
+
+    // • Accessors : toroidal
+    //
+    const FieldValue& wrapped(int64_t x, int64_t y) const noexcept
+    {
+        const auto wx = static_cast<uint32_t>( (x % m_width  + m_width)  % m_width  );
+        const auto wy = static_cast<uint32_t>( (y % m_height + m_height) % m_height );
+
+        return at(wx, wy);
+    }
+
+    // • Methods : transfer, a tile row at a time
+    //
+    void load(const Grid& grid) noexcept(false)
+    {
+        if ( grid.width() != m_width || grid.height() != m_height ) {
+            throw false;
+        }
+
+        for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+        {
+            for ( auto x = uint32_t{ 0 }; x < m_width; x += tile_side )
+            {
+                std::copy_n( grid.row(y) + x, std::min(tile_side, m_width - x), tile_row(x, y) );
+            }
+        }
+    }
+
+    void store(Grid& grid) const noexcept(false)
+    {
+        if ( grid.width() != m_width || grid.height() != m_height ) {
+            throw false;
+        }
+
+        for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+        {
+            for ( auto x = uint32_t{ 0 }; x < m_width; x += tile_side )
+            {
+                std::copy_n( tile_row(x, y), std::min(tile_side, m_width - x), grid.row(y) + x );
+            }
+        }
+    }
+
+private:
+
+    // • Data members
+    //
+    uint32_t                m_width;
+    uint32_t                m_height;
+    uint32_t                m_tiles_x;
+    uint32_t                m_tiles_y;
+    std::vector<uint32_t>   m_tile_order;   // slot -> row-major tile index
+    std::vector<uint32_t>   m_tile_slots;   // row-major tile index -> slot
+    std::vector<FieldValue> m_values;
+};
+
+//===------------------------------------------------------------------------===
+// • Blocked step
+//
+//  Steps one tile at a time in storage order. The alive values of the tile
+//  and an r cell apron are gathered a tile row at a time, the apron from
+//  the neighboring tiles, and turned into a summed-area table, so every
+//  neighbor count is four reads whatever the radius, the same scheme as
+//  step_field_ltl in StepField.metal. Square neighborhoods, torus boundary
+//  and deterministic rules only.
+//===------------------------------------------------------------------------===
+
+template <uint32_t TileSide_>
+void step(const BlockedGrid<TileSide_>& source, BlockedGrid<TileSide_>& dest,
+          const AutomatRule& rule) noexcept(false)
+{
+    if ( source.width() != dest.width() || source.height() != dest.height() ) {
+        throw false;
+    }
+
+    assert( is_moore(rule) && is_torus(rule) && !is_stochastic(rule) );
+
+    constexpr auto max_span = TileSide_ + 2u * max_neighborhood_radius;
+    constexpr auto stride   = max_span + 1u;
+
+    const auto width  = source.width();
+    const auto height = source.height();
+    const auto radius = std::min( neighborhood_radius(rule), uint32_t{ max_neighborhood_radius } );
+
+    // • Table with a leading row and column of zeros
+    //
+    auto table = std::vector<uint16_t>( size_t{ stride } * stride, 0 );
+
+    // • Alive after a settled step, by alive and neighbor count
+    //
+    const auto count_limit = (2u * radius + 1u) * (2u * radius + 1u);
+    const auto durations   = std::array<uint8_t, 2>{ rule.decline_duration, rule.growth_duration };
+
+    auto next_alive = std::vector<uint8_t>( 2u * count_limit );
+
+    for ( auto count = uint32_t{ 0 }; count < count_limit; ++count )
+    {
+        next_alive[count]               = is_born(rule, count)  ? 1u : 0u;
+        next_alive[count_limit + count] = survives(rule, count) ? 1u : 0u;
+    }
+
+    for ( auto slot = size_t{ 0 }; slot < source.tile_count(); ++slot )
+    {
+        const auto origin = source.tile_origin(slot);
+        const auto w      = std::min(TileSide_, width  - origin.x);
+        const auto h      = std::min(TileSide_, height - origin.y);
+
+        // • Alive values of the tile and its apron, as running row sums
+        //
+        for ( auto ay = uint32_t{ 0 }; ay < h + 2u * radius; ++ay )
+        {
+            const auto y   = static_cast<uint32_t>( ( (int64_t{ origin.y } + ay - radius) % height + height ) % height );
+            auto*      row = table.data() + size_t{ ay + 1u } * stride + 1u;
+            auto       sum = uint16_t{ 0 };
+
+            for ( auto ax = uint32_t{ 0 }; ax < radius; ++ax ) {
+                row[ax] = sum += source.wrapped( int64_t{ origin.x } + ax - radius, y ).alive;
+            }
+
+            const auto* cells = source.tile_row(origin.x, y);
+
+            for ( auto x = uint32_t{ 0 }; x < w; ++x ) {
+                row[radius + x] = sum += cells[x].alive;
+            }
+
+            for ( auto ax = uint32_t{ 0 }; ax < radius; ++ax ) {
+                row[radius + w + ax] = sum += source.wrapped( int64_t{ origin.x } + w + ax, y ).alive;
+            }
+
+            // • Column sums
+            //
+            const auto* above = row - stride;
+
+            for ( auto ax = uint32_t{ 0 }; ax < w + 2u * radius; ++ax ) {
+                row[ax] += above[ax];
+            }
+        }
+
+        // • Step the tile's cells
+        //
+        const auto* in  = source.tile(slot);
+        auto*       out = dest.tile(slot);
+        const auto  d   = 2u * radius + 1u;
+
+        for ( auto y = uint32_t{ 0 }; y < h; ++y )
+        {
+            const auto* upper = table.data() + size_t{ y }     * stride;
+            const auto* lower = table.data() + size_t{ y + d } * stride;
+
+            for ( auto x = uint32_t{ 0 }; x < w; ++x )
+            {
+                auto value = in[ (y << BlockedGrid<TileSide_>::tile_shift) + x ];
+
+                if ( 0 < value.step )
+                {
+                    --value.step;
+                }
+                else
+                {
+                    // • Settled: select rather than branch on the transition,
+                    //      which is as likely as not in an active region
+                    //
+                    const auto count = uint32_t{ lower[x + d] } - lower[x] - upper[x + d] + upper[x]
+                                     - value.alive;
+                    const auto alive = next_alive[ value.alive * count_limit + count ];
+                    const auto moved = alive != value.alive;
+
+                    value.alive    = alive;
+                    value.step     = moved ? durations[alive] : uint8_t{ 0 };
+                    value.duration = moved ? durations[alive] : value.duration;
+                }
+
+                out[ (y << BlockedGrid<TileSide_>::tile_shift) + x ] = value;
+            }
+        }
+    }
+}
+
+} // namespace field
@@ -0,0 +1,558 @@
+//
+//  BytePlanes.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/BytePlanes.hpp>
+#include <Field/FieldHash.hpp>
+#include <Field/RuleKernel.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+inline uint64_t load_word(const uint8_t* source) noexcept
+{
+    auto word = uint64_t{ 0 };
+    std::memcpy(&word, source, sizeof(word));
+
+    return word;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+BytePlanes::BytePlanes(uint32_t width, uint32_t height) noexcept(false)
+    :
+        m_width       { width     },
+        m_height      { height    },
+        m_alive_stride{ width + 2 },
+        m_current     { 0         }
+{
+    if ( 0 == width || 0 == height ) {
+        throw false;
+    }
+
+    const auto cell_count = size_t{ width } * height;
+
+    for ( auto& planes : m_planes )
+    {
+        planes.alive.assign   ( size_t{ m_alive_stride } * (height + 2u), 0 );
+        planes.step.assign    ( cell_count, 0 );
+        planes.duration.assign( cell_count, 0 );
+    }
+
+    m_column_sums.assign( width, 0 );
+}
+
+//===------------------------------------------------------------------------===
+// • Accessors
+//===------------------------------------------------------------------------===
+
+FieldValue BytePlanes::value(uint32_t x, uint32_t y) const noexcept
+{
+    assert( x < m_width && y < m_height );
+
+    const auto& planes = m_planes[m_current];
+    const auto  index  = size_t{ y } * m_width + x;
+
+    return {
+        .alive    = alive_row(planes, y)[x],
+        .step     = planes.step[index],
+        .duration = planes.duration[index],
+        .reserved = 0
+    };
+}
+
+uint64_t BytePlanes::hash(void) const noexcept
+{
+    const auto& planes = m_planes[m_current];
+    auto        hash   = uint64_t{ 0 };
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto offset = size_t{ y } * m_width;
+        const auto alive  = alive_row(planes, y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            hash ^= cell_hash( offset + x, alive[x], planes.step[offset + x], planes.duration[offset + x] );
+        }
+    }
+
+    return hash;
+}
+
+//===------------------------------------------------------------------------===
+// • Transfer
+//===------------------------------------------------------------------------===
+
+void BytePlanes::load(const Grid& grid) noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    auto& planes = m_planes[m_current];
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto src      = grid.row(y);
+        auto       alive    = alive_row(planes, y);
+        auto       step     = planes.step.data()     + size_t{ y } * m_width;
+        auto       duration = planes.duration.data() + size_t{ y } * m_width;
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            alive[x]    = ( 0 != src[x].alive ) ? 1 : 0;
+            step[x]     = src[x].step;
+            duration[x] = src[x].duration;
+        }
+    }
+}
+
+void BytePlanes::store(Grid& grid) const noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    const auto& planes = m_planes[m_current];
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto alive    = alive_row(planes, y);
+        const auto step     = planes.step.data()     + size_t{ y } * m_width;
+        const auto duration = planes.duration.data() + size_t{ y } * m_width;
+
+        auto dest = grid.row(y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            dest[x] = { alive[x], step[x], duration[x], 0 };
+        }
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Step
+//===------------------------------------------------------------------------===
+
+StepRow BytePlanes::step_row(const Planes& source, Planes& dest, uint32_t y) noexcept
+{
+    const auto offset = size_t{ y } * m_width;
+
+    return {
+        .upper         = alive_row( source, y ) - m_alive_stride,
+        .middle        = alive_row( source, y ),
+        .lower         = alive_row( source, y ) + m_alive_stride,
+        .step          = source.step.data()     + offset,
+        .duration      = source.duration.data() + offset,
+        .next_alive    = alive_row( dest, y ),
+        .next_step     = dest.step.data()       + offset,
+        .next_duration = dest.duration.data()   + offset,
+        .counts        = nullptr
+    };
+}
+
+void BytePlanes::step(const AutomatRule& rule) noexcept
+{
+    assert( !is_stochastic(rule) );
+
+    if ( is_larger_than_life(rule) ) {
+        step_larger_than_life(rule);
+    }
+    else {
+        step( rule, step_row_kernel(rule), step_row_kernel(rule, true) );
+    }
+}
+
+void BytePlanes::step(const AutomatRule& rule, StepRowKernel kernel, StepRowKernel odd_kernel) noexcept
+{
+    assert( !is_stochastic(rule) );
+
+    auto&      source  = m_planes[m_current];
+    auto&      dest    = m_planes[m_current ^ 1u];
+    const auto kernels = std::array{ kernel, odd_kernel ? odd_kernel : kernel };
+
+    update_ghost_ring(source, rule.boundary);
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        kernels[y & 1u](step_row(source, dest, y), m_width, rule);
+    }
+
+    m_current ^= 1u;
+}
+
+void BytePlanes::step(const AutomatRule& rule, const TorusRegion& region) noexcept
+{
+    assert( !is_larger_than_life(rule) && is_torus(rule) && !is_stochastic(rule) );
+    assert( region.left < m_width && region.top < m_height );
+    assert( region.width <= m_width && region.height <= m_height );
+
+    auto&      source  = m_planes[m_current];
+    auto&      dest    = m_planes[m_current ^ 1u];
+    const auto kernels = std::array{ step_row_kernel(rule), step_row_kernel(rule, true) };
+
+    update_ghost_ring(source, rule.boundary);
+
+    // • Columns wrap into at most two runs
+    //
+    const auto first_count  = std::min(region.width, m_width - region.left);
+    const auto second_count = region.width - first_count;
+
+    for ( auto r = uint32_t{ 0 }; r < region.height; ++r )
+    {
+        const auto y = (region.top + r) % m_height;
+
+        const auto step_run = [&](uint32_t x, uint32_t count)
+        {
+            const auto offset = size_t{ y } * m_width + x;
+
+            const auto row = StepRow {
+                .upper         = alive_row( source, y ) - m_alive_stride + x,
+                .middle        = alive_row( source, y ) + x,
+                .lower         = alive_row( source, y ) + m_alive_stride + x,
+                .step          = source.step.data()     + offset,
+                .duration      = source.duration.data() + offset,
+                .next_alive    = alive_row( dest, y ) + x,
+                .next_step     = dest.step.data()       + offset,
+                .next_duration = dest.duration.data()   + offset,
+                .counts        = nullptr
+            };
+
+            kernels[y & 1u](row, count, rule);
+        };
+
+        step_run(region.left, first_count);
+
+        if ( 0 < second_count ) {
+            step_run(0, second_count);
+        }
+    }
+
+    m_current ^= 1u;
+}
+
+uint64_t BytePlanes::step_hashed(const AutomatRule& rule, uint64_t hash) noexcept
+{
+    assert( !is_stochastic(rule) );
+
+    auto& source = m_planes[m_current];
+    auto& dest   = m_planes[m_current ^ 1u];
+
+    if ( is_larger_than_life(rule) )
+    {
+        step_larger_than_life(rule);
+
+        for ( auto y = uint32_t{ 0 }; y < m_height; ++y ) {
+            rehash_row( step_row(source, dest, y), y, hash );
+        }
+
+        return hash;
+    }
+
+    const auto kernels = std::array{ step_row_kernel(rule), step_row_kernel(rule, true) };
+
+    update_ghost_ring(source, rule.boundary);
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto row = step_row(source, dest, y);
+
+        kernels[y & 1u](row, m_width, rule);
+
+        // • Compare while the row is still in cache
+        //
+        rehash_row(row, y, hash);
+    }
+
+    m_current ^= 1u;
+
+    return hash;
+}
+
+// • Compares eight cells at a time and only rehashes the cells of words
+//      that differ
+//
+void BytePlanes::rehash_row(const StepRow& row, uint32_t y, uint64_t& hash) const noexcept
+{
+    const auto offset = size_t{ y } * m_width;
+
+    const auto rehash = [&](uint32_t x) noexcept
+    {
+        if ( row.middle[x] != row.next_alive[x] || row.step[x] != row.next_step[x]
+          || row.duration[x] != row.next_duration[x] )
+        {
+            hash ^= cell_hash( offset + x, row.middle[x],     row.step[x],      row.duration[x] )
+                  ^ cell_hash( offset + x, row.next_alive[x], row.next_step[x], row.next_duration[x] );
+        }
+    };
+
+    auto x = uint32_t{ 0 };
+
+    for ( ; x + 8u <= m_width; x += 8u )
+    {
+        const auto changed = ( load_word(row.middle + x)   ^ load_word(row.next_alive + x)    )
+                           | ( load_word(row.step + x)     ^ load_word(row.next_step + x)     )
+                           | ( load_word(row.duration + x) ^ load_word(row.next_duration + x) );
+        if ( 0 != changed )
+        {
+            for ( auto i = x; i < x + 8u; ++i ) {
+                rehash(i);
+            }
+        }
+    }
+
+    for ( ; x < m_width; ++x ) {
+        rehash(x);
+    }
+}
+
+void BytePlanes::step_changes(const AutomatRule& rule, std::vector<uint8_t>& changes) noexcept(false)
+{
+    assert( !is_stochastic(rule) );
+
+    auto& source = m_planes[m_current];
+    auto& dest   = m_planes[m_current ^ 1u];
+
+    changes.resize( size_t{ m_width } * m_height );
+
+    if ( is_larger_than_life(rule) )
+    {
+        step_larger_than_life(rule);
+
+        for ( auto y = uint32_t{ 0 }; y < m_height; ++y ) {
+            mark_changes( step_row(source, dest, y), changes.data() + size_t{ y } * m_width );
+        }
+
+        return;
+    }
+
+    const auto kernels = std::array{ step_row_kernel(rule), step_row_kernel(rule, true) };
+
+    update_ghost_ring(source, rule.boundary);
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto row = step_row(source, dest, y);
+
+        kernels[y & 1u](row, m_width, rule);
+
+        // • Compare while the row is still in cache
+        //
+        mark_changes( row, changes.data() + size_t{ y } * m_width );
+    }
+
+    m_current ^= 1u;
+}
+
+// • Alive bytes are zero or one, so their xor marks the changes, eight at a
+//      time
+//
+void BytePlanes::mark_changes(const StepRow& row, uint8_t* changes) const noexcept
+{
+    auto x = uint32_t{ 0 };
+
+    for ( ; x + 8u <= m_width; x += 8u )
+    {
+        const auto changed = load_word(row.middle + x) ^ load_word(row.next_alive + x);
+        std::memcpy(changes + x, &changed, sizeof(changed));
+    }
+
+    for ( ; x < m_width; ++x ) {
+        changes[x] = row.middle[x] ^ row.next_alive[x];
+    }
+}
+
+void BytePlanes::step_larger_than_life(const AutomatRule& rule) noexcept
+{
+    const auto& source = m_planes[m_current];
+    auto&       dest   = m_planes[m_current ^ 1u];
+    const auto  radius = int{ rule.radius };
+    const auto  span   = m_width + 2u * radius;
+    auto*       sums   = m_column_sums.data();
+
+    // • Row beyond an edge through the boundary, or nullptr for dead cells
+    //
+    const auto boundary_row = [&](int y) noexcept -> const uint8_t*
+    {
+        const auto by = boundary_index(y, int( m_height ), rule.boundary);
+
+        return ( by < 0 ) ? nullptr : alive_row( source, uint32_t( by ) );
+    };
+
+    // • Column of each window sum, r columns beyond either edge
+    //
+    m_window_sums.resize(span);
+    m_column_map.resize(span);
+
+    for ( auto i = uint32_t{ 0 }; i < span; ++i ) {
+        m_column_map[i] = boundary_index(int( i ) - radius, int( m_width ), rule.boundary);
+    }
+
+    // • Column sums over rows -r ... r around row 0
+    //
+    std::fill( m_column_sums.begin(), m_column_sums.end(), uint16_t{ 0 } );
+
+    for ( auto dy = -radius; dy <= radius; ++dy )
+    {
+        if ( const auto alive = boundary_row(dy) )
+        {
+            for ( auto x = uint32_t{ 0 }; x < m_width; ++x ) {
+                sums[x] += alive[x];
+            }
+        }
+    }
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        // • Extend the column sums through the boundary, then slide the
+        //      window along the row: x - r ... x + r
+        //
+        for ( auto i = uint32_t{ 0 }; i < span; ++i )
+        {
+            const auto column = m_column_map[i];
+            m_window_sums[i]  = ( column < 0 ) ? uint16_t{ 0 } : sums[column];
+        }
+
+        const auto* window = m_window_sums.data();
+        auto        count  = uint32_t{ 0 };
+
+        for ( auto i = 0; i < 2 * radius; ++i ) {
+            count += window[i];
+        }
+
+        const auto row = step_row(source, dest, y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            count += window[x + 2u * radius];
+
+            const auto value = field::step( FieldValue{ row.middle[x], row.step[x], row.duration[x], 0 },
+                                            count - row.middle[x], rule );
+
+            row.next_alive[x]    = value.alive;
+            row.next_step[x]     = value.step;
+            row.next_duration[x] = value.duration;
+
+            count -= window[x];
+        }
+
+        // • Move the column sums down one row
+        //
+        if ( const auto entering = boundary_row( int( y ) + radius + 1 ) )
+        {
+            for ( auto x = uint32_t{ 0 }; x < m_width; ++x ) {
+                sums[x] = static_cast<uint16_t>( sums[x] + entering[x] );
+            }
+        }
+
+        if ( const auto leaving = boundary_row( int( y ) - radius ) )
+        {
+            for ( auto x = uint32_t{ 0 }; x < m_width; ++x ) {
+                sums[x] = static_cast<uint16_t>( sums[x] - leaving[x] );
+            }
+        }
+    }
+
+    m_current ^= 1u;
+}
+
+void BytePlanes::update_ghost_ring(Planes& planes, uint8_t boundary) noexcept
+{
+    const auto last = m_width - 1u;
+
+    // • Ghost columns, then ghost rows copied whole so the corners follow
+    //
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        auto* alive = alive_row(planes, y);
+
+        switch ( boundary )
+        {
+            case boundary_dead:
+                alive[-1]      = 0;
+                alive[m_width] = 0;
+                break;
+
+            case boundary_mirror:
+                alive[-1]      = alive[0];
+                alive[m_width] = alive[last];
+                break;
+
+            default:
+                alive[-1]      = alive[last];
+                alive[m_width] = alive[0];
+                break;
+        }
+    }
+
+    auto* top    = planes.alive.data();
+    auto* bottom = planes.alive.data() + size_t{ m_height + 1u } * m_alive_stride;
+
+    const auto* first_row = alive_row(planes, 0) - 1;
+    const auto* last_row  = alive_row(planes, m_height - 1u) - 1;
+
+    switch ( boundary )
+    {
+        case boundary_dead:
+            std::fill_n(top,    m_alive_stride, uint8_t{ 0 });
+            std::fill_n(bottom, m_alive_stride, uint8_t{ 0 });
+            break;
+
+        case boundary_mirror:
+            std::copy_n(first_row, m_alive_stride, top);
+            std::copy_n(last_row,  m_alive_stride, bottom);
+            break;
+
+        default:
+            std::copy_n(last_row,  m_alive_stride, top);
+            std::copy_n(first_row, m_alive_stride, bottom);
+            break;
+    }
+}
+
+void BytePlanes::step(const AutomatRule& rule, LightCone& cone) noexcept
+{
+    if ( !cone.is_complete() )
+    {
+        step( rule, cone.region() );
+        cone.advance();
+    }
+}
+
+} // namespace field
@@ -0,0 +1,151 @@
+//
+//  BytePlanes.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/LightCone.hpp>
+#include <Field/StepKernel.hpp>
+
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+//
+// • BytePlanes
+//
+//  Field with the FieldValue channels split into separate alive, step and
+//  duration planes of one byte per cell, so that the step kernels process
+//  16, 32 or 64 cells per instruction. The alive plane is surrounded by a
+//  ring of ghost cells, refreshed from the rule's boundary at the start of
+//  each step, so the kernels never wrap or test an edge. Each row is stepped
+//  by the kernel of the rule's topology for its parity.
+//
+//  Larger than Life rules are counted with sliding windows instead: column
+//  sums over 2r + 1 rows are updated by one row in and one row out per
+//  row, and each row's counts slide along them by one column in and one
+//  out per cell, so the cost per cell does not depend on the radius. Rows
+//  and columns beyond the edges are mapped through the boundary once per
+//  row and once per step respectively.
+//
+//===------------------------------------------------------------------------===
+
+class BytePlanes
+{
+public:
+
+    // • Initialization
+    //
+    BytePlanes(uint32_t width, uint32_t height) noexcept(false);
+
+    // • Accessors : dimensions
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    // • Accessors : values
+    //
+    FieldValue value(uint32_t x, uint32_t y) const noexcept;
+
+    // • Accessors : field hash (full computation)
+    //
+    uint64_t hash(void) const noexcept;
+
+    // • Methods : transfer
+    //
+    void load(const Grid& grid) noexcept(false);
+    void store(Grid& grid) const noexcept(false);
+
+    // • Methods : step (deterministic rules only; an odd row kernel for the
+    //      hexagonal topology, otherwise kernel steps every row)
+    //
+    void step(const AutomatRule& rule) noexcept;
+    void step(const AutomatRule& rule, StepRowKernel kernel, StepRowKernel odd_kernel = nullptr) noexcept;
+
+    // • Methods : step part of the field, leaving the rest stale (radius 1
+    //      neighborhoods, torus boundary and deterministic rules only)
+    //
+    void step(const AutomatRule& rule, const TorusRegion& region) noexcept;
+    void step(const AutomatRule& rule, LightCone& cone) noexcept;
+
+    // • Methods : step, updating the field hash from the cells that changed
+    //
+    uint64_t step_hashed(const AutomatRule& rule, uint64_t hash) noexcept;
+
+    // • Methods : step, marking the cells whose alive state changed with a one
+    //      in changes, a byte per cell in raster order (resized to fit)
+    //
+    void step_changes(const AutomatRule& rule, std::vector<uint8_t>& changes) noexcept(false);
+
+private:
+
+    // • Planes (private)
+    //
+    struct Planes
+    {
+        std::vector<uint8_t>    alive;      // stride m_alive_stride, ghost ring
+        std::vector<uint8_t>    step;       // stride m_width
+        std::vector<uint8_t>    duration;   // stride m_width
+    };
+
+    uint8_t* alive_row(Planes& planes, uint32_t y) noexcept
+    {
+        return planes.alive.data() + size_t{ y + 1u } * m_alive_stride + 1u;
+    }
+
+    const uint8_t* alive_row(const Planes& planes, uint32_t y) const noexcept
+    {
+        return planes.alive.data() + size_t{ y + 1u } * m_alive_stride + 1u;
+    }
+
+    StepRow step_row(const Planes& source, Planes& dest, uint32_t y) noexcept;
+
+    void step_larger_than_life(const AutomatRule& rule) noexcept;
+    void rehash_row(const StepRow& row, uint32_t y, uint64_t& hash) const noexcept;
+    void mark_changes(const StepRow& row, uint8_t* changes) const noexcept;
+
+    void update_ghost_ring(Planes& planes, uint8_t boundary) noexcept;
+
+    // • Data members
+    //
+    uint32_t    m_width;
+    uint32_t    m_height;
+    uint32_t    m_alive_stride;
+    Planes      m_planes[2];
+    uint32_t    m_current;
+
+    std::vector<uint16_t>   m_column_sums;  // Larger than Life
+    std::vector<uint16_t>   m_window_sums;  // Larger than Life, r columns beyond each edge
+    std::vector<int32_t>    m_column_map;   // Larger than Life, column of each window sum
+};
+
+} // namespace field
@@ -0,0 +1,108 @@
+//
+//  CellPacking.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/CellPacking.hpp>
+
+#include <cstring>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Packing
+//===------------------------------------------------------------------------===
+
+void pack(const FieldValue* values, size_t count, uint32_t cell_size, void* cells) noexcept(false)
+{
+    if ( 1u == cell_size )
+    {
+        auto* dest = static_cast<uint8_t*>(cells);
+
+        for ( auto i = size_t{ 0 }; i < count; ++i )
+        {
+            if ( packed_cell8_max_step < values[i].step ) {
+                throw false;
+            }
+
+            dest[i] = static_cast<uint8_t>( pack(values[i]) );
+        }
+    }
+    else if ( 2u == cell_size )
+    {
+        auto* dest = static_cast<uint8_t*>(cells);
+
+        for ( auto i = size_t{ 0 }; i < count; ++i )
+        {
+            const auto cell = pack(values[i]);
+            std::memcpy(dest + 2u * i, &cell, 2u);
+        }
+    }
+    else
+    {
+        throw false;
+    }
+}
+
+void pack(const Grid& grid, uint32_t cell_size, void* cells) noexcept(false)
+{
+    pack(grid.data(), grid.size(), cell_size, cells);
+}
+
+//===------------------------------------------------------------------------===
+// • Unpacking
+//===------------------------------------------------------------------------===
+
+void unpack(const void* cells, size_t count, uint32_t cell_size,
+            const AutomatRule& rule, FieldValue* values) noexcept(false)
+{
+    const auto* source = static_cast<const uint8_t*>(cells);
+
+    if ( 1u == cell_size )
+    {
+        for ( auto i = size_t{ 0 }; i < count; ++i )
+        {
+            values[i] = unpack(source[i], rule);
+        }
+    }
+    else if ( 2u == cell_size )
+    {
+        for ( auto i = size_t{ 0 }; i < count; ++i )
+        {
+            auto cell = PackedCell{ 0 };
+            std::memcpy(&cell, source + 2u * i, 2u);
+
+            values[i] = unpack(cell, rule);
+        }
+    }
+    else
+    {
+        throw false;
+    }
+}
+
+void unpack(const void* cells, uint32_t cell_size, const AutomatRule& rule, Grid& grid) noexcept(false)
+{
+    unpack(cells, grid.size(), cell_size, rule, grid.data());
+}
+
+} // namespace field
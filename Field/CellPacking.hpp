@@ -0,0 +1,84 @@
+//
+//  CellPacking.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+#include <Shaders/Data/FieldValue.hpp>
+#include <Shaders/Data/PackedCell.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Cell packing
+//
+//  Conversions between FieldValues and the PackedCells of the field
+//  textures. Packing drops the duration; unpacking restores it from the
+//  rule for a cell that is counting down and leaves it zero for a settled
+//  one, whose duration neither stepping nor colorization reads. Packed
+//  cells are one or two bytes each, row-major with no row padding.
+//===------------------------------------------------------------------------===
+
+// • Bytes per packed cell under a rule: 1 while both durations fit in 7 bits
+//
+constexpr uint32_t packed_cell_size(const AutomatRule& rule) noexcept
+{
+    return ( rule.growth_duration  <= packed_cell8_max_step
+          && rule.decline_duration <= packed_cell8_max_step ) ? 1u : 2u;
+}
+
+constexpr PackedCell pack(const FieldValue& value) noexcept
+{
+    return make_packed_cell(0 != value.alive, value.step);
+}
+
+constexpr FieldValue unpack(PackedCell cell, const AutomatRule& rule) noexcept
+{
+    const auto alive = packed_alive(cell);
+    const auto step  = static_cast<uint8_t>( packed_step(cell) );
+
+    const auto duration = ( 0 == step ) ? uint8_t{ 0 }
+                        : alive         ? rule.growth_duration
+                        :                 rule.decline_duration;
+
+    return { static_cast<uint8_t>(alive), step, duration, 0 };
+}
+
+// • Packs count values into cell_size-byte cells (throws when cell_size is
+//      not 1 or 2, or a step does not fit)
+//
+void pack(const FieldValue* values, size_t count, uint32_t cell_size, void* cells) noexcept(false);
+void pack(const Grid& grid, uint32_t cell_size, void* cells) noexcept(false);
+
+// • Unpacks count cell_size-byte cells (throws when cell_size is not 1 or 2)
+//
+void unpack(const void* cells, size_t count, uint32_t cell_size,
+            const AutomatRule& rule, FieldValue* values) noexcept(false);
+void unpack(const void* cells, uint32_t cell_size, const AutomatRule& rule, Grid& grid) noexcept(false);
+
+} // namespace field
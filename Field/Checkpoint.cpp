@@ -0,0 +1,325 @@
+//
+//  Checkpoint.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/Checkpoint.hpp>
+#include <Field/CellPacking.hpp>
+
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+//===------------------------------------------------------------------------===
+// • File layout
+//
+//  [CheckpointHeader] [PackedCell × width × height], row-major with no row
+//  padding, of cell_size bytes each. The version changes whenever the
+//  layout or the meaning of a stored step does, which invalidates every
+//  existing entry.
+//===------------------------------------------------------------------------===
+
+enum : uint32_t
+{
+    checkpoint_magic   = 0x54586370, // 'TXcp'
+    checkpoint_version = 2
+};
+
+struct CheckpointHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint64_t    content;
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    step_count;
+    uint32_t    cell_size;
+    uint64_t    checksum;
+};
+
+static_assert( 40 == sizeof(CheckpointHeader), "Unexpected size" );
+static_assert( 0 == sizeof(CheckpointHeader) % alignof(PackedCell), "Unexpected alignment" );
+
+constexpr bool is_valid_cell_size(uint32_t cell_size) noexcept
+{
+    return 1u == cell_size || 2u == cell_size;
+}
+
+constexpr size_t payload_length(uint32_t width, uint32_t height, uint32_t cell_size) noexcept
+{
+    return size_t{ width } * height * cell_size;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • ContentHash
+//===------------------------------------------------------------------------===
+
+void ContentHash::append(const void* bytes, size_t length) noexcept
+{
+    const auto* source = static_cast<const uint8_t*>(bytes);
+
+    for ( auto i = size_t{ 0 }; i < length; ++i )
+    {
+        m_value = ( m_value ^ source[i] ) * 0x100000001b3;
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Checksum
+//===------------------------------------------------------------------------===
+
+uint64_t checksum(const void* bytes, size_t length) noexcept
+{
+    constexpr auto k0 = uint64_t{ 0x9e3779b97f4a7c15 };
+    constexpr auto k1 = uint64_t{ 0xbf58476d1ce4e5b9 };
+
+    const auto* source = static_cast<const uint8_t*>(bytes);
+    auto        value  = uint64_t{ length } * k0;
+
+    for ( ; 8 <= length; source += 8, length -= 8 )
+    {
+        auto word = uint64_t{ 0 };
+        std::memcpy(&word, source, 8);
+
+        value = std::rotl(value ^ (word * k1), 29) * k0;
+    }
+
+    auto tail = uint64_t{ 0 };
+    std::memcpy(&tail, source, length);
+
+    value = std::rotl(value ^ (tail * k1), 29) * k0;
+
+    return value ^ (value >> 32);
+}
+
+//===------------------------------------------------------------------------===
+// • CheckpointKey
+//===------------------------------------------------------------------------===
+
+uint64_t hash(const CheckpointKey& key) noexcept
+{
+    auto content_hash = ContentHash{};
+
+    content_hash << key.content << key.width << key.height << key.step_count;
+
+    return content_hash.value();
+}
+
+//===------------------------------------------------------------------------===
+// • MappedCheckpoint
+//===------------------------------------------------------------------------===
+
+MappedCheckpoint::MappedCheckpoint(const std::filesystem::path& path, const CheckpointKey& key) noexcept(false)
+    :
+        m_file     { path       },
+        m_cells    { nullptr    },
+        m_width    { key.width  },
+        m_height   { key.height },
+        m_cell_size{ 0          }
+{
+    if ( m_file.size() < sizeof(CheckpointHeader) ) {
+        throw false;
+    }
+
+    auto header = CheckpointHeader{};
+    std::memcpy(&header, m_file.data(), sizeof(header));
+
+    if ( checkpoint_magic   != header.magic
+      || checkpoint_version != header.version
+      || key.content        != header.content
+      || key.width          != header.width
+      || key.height         != header.height
+      || key.step_count     != header.step_count
+      || !is_valid_cell_size(header.cell_size) )
+    {
+        throw false;
+    }
+
+    const auto  length  = payload_length(key.width, key.height, header.cell_size);
+    const auto* payload = m_file.data() + sizeof(header);
+
+    if ( m_file.size() != sizeof(CheckpointHeader) + length
+      || checksum(payload, length) != header.checksum )
+    {
+        throw false;
+    }
+
+    m_cells     = payload;
+    m_cell_size = header.cell_size;
+}
+
+void MappedCheckpoint::copy_to(Grid& grid, const AutomatRule& rule) const noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    unpack(m_cells, m_cell_size, rule, grid);
+}
+
+//===------------------------------------------------------------------------===
+// • CheckpointCache
+//===------------------------------------------------------------------------===
+
+CheckpointCache::CheckpointCache(std::filesystem::path directory) noexcept(false)
+    :
+        m_directory{ std::move(directory) }
+{
+    auto error = std::error_code{};
+
+    std::filesystem::create_directories(m_directory, error);
+
+    if ( !std::filesystem::is_directory(m_directory, error) ) {
+        throw false;
+    }
+}
+
+std::filesystem::path CheckpointCache::path(const CheckpointKey& key) const noexcept(false)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.checkpoint", static_cast<unsigned long long>( hash(key) ));
+
+    return m_directory / name;
+}
+
+std::optional<MappedCheckpoint> CheckpointCache::load(const CheckpointKey& key) const noexcept
+{
+    try
+    {
+        const auto entry_path = path(key);
+        auto       error      = std::error_code{};
+
+        if ( !std::filesystem::exists(entry_path, error) ) {
+            return std::nullopt;
+        }
+
+        try
+        {
+            return MappedCheckpoint{ entry_path, key };
+        }
+        catch ( bool )
+        {
+            // • Mismatched or corrupt: drop it so the next store replaces it
+            //
+            std::filesystem::remove(entry_path, error);
+        }
+    }
+    catch ( ... )
+    {
+    }
+
+    return std::nullopt;
+}
+
+bool CheckpointCache::store(const CheckpointKey& key, const void* cells, uint32_t cell_size) const noexcept
+{
+    if ( !is_valid_cell_size(cell_size) ) {
+        return false;
+    }
+
+    try
+    {
+        const auto length     = payload_length(key.width, key.height, cell_size);
+        const auto entry_path = path(key);
+        const auto temp_path  = temporary_path(entry_path);
+
+        const auto header = CheckpointHeader {
+            .magic      = checkpoint_magic,
+            .version    = checkpoint_version,
+            .content    = key.content,
+            .width      = key.width,
+            .height     = key.height,
+            .step_count = key.step_count,
+            .cell_size  = cell_size,
+            .checksum   = checksum(cells, length)
+        };
+
+        const auto descriptor = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+
+        if ( descriptor < 0 ) {
+            return false;
+        }
+
+        const auto written = write_all(descriptor, &header, sizeof(header))
+                          && write_all(descriptor, cells, length);
+
+        auto error = std::error_code{};
+
+        if ( 0 != ::close(descriptor) || !written )
+        {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        std::filesystem::rename(temp_path, entry_path, error);
+
+        if ( error )
+        {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        return true;
+    }
+    catch ( ... )
+    {
+        return false;
+    }
+}
+
+bool CheckpointCache::store(const CheckpointKey& key, const Grid& grid, const AutomatRule& rule) const noexcept
+{
+    if ( grid.width() != key.width || grid.height() != key.height ) {
+        return false;
+    }
+
+    try
+    {
+        const auto cell_size = packed_cell_size(rule);
+        auto       cells     = std::vector<uint8_t>( grid.size() * cell_size );
+
+        pack(grid, cell_size, cells.data());
+
+        return store(key, cells.data(), cell_size);
+    }
+    catch ( ... )
+    {
+        return false;
+    }
+}
+
+} // namespace field
@@ -0,0 +1,208 @@
+//
+//  Checkpoint.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/MappedFile.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <type_traits>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • ContentHash
+//
+//  64-bit FNV-1a over the bytes of trivially copyable values. Values are
+//  appended one at a time so that structure padding is never hashed.
+//===------------------------------------------------------------------------===
+
+class ContentHash
+{
+public:
+
+    // • Accessors
+    //
+    constexpr uint64_t value(void) const noexcept
+    {
+        return m_value;
+    }
+
+    // • Methods
+    //
+    void append(const void* bytes, size_t length) noexcept;
+
+    template <typename Type_>
+        requires std::is_trivially_copyable_v<Type_>
+    ContentHash& operator << (const Type_& value) noexcept
+    {
+        append(&value, sizeof(Type_));
+        return *this;
+    }
+
+private:
+
+    // • Data members
+    //
+    uint64_t    m_value = 0xcbf29ce484222325;
+};
+
+// • Checksum of a stored payload, eight bytes at a time so that large fields
+//      validate at memory speed
+//
+uint64_t checksum(const void* bytes, size_t length) noexcept;
+
+//===------------------------------------------------------------------------===
+// • CheckpointKey
+//
+//  Everything the field state after warm-up depends on: a hash of the
+//  initialization and the rule, the field dimensions and the number of
+//  warm-up steps
+//===------------------------------------------------------------------------===
+
+struct CheckpointKey
+{
+    uint64_t    content;
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    step_count;
+
+    constexpr bool operator == (const CheckpointKey& ) const noexcept = default;
+};
+
+uint64_t hash(const CheckpointKey& key) noexcept;
+
+//===------------------------------------------------------------------------===
+//
+// • MappedCheckpoint
+//
+//  Read-only mapping of a checkpoint file. The header is checked against the
+//  expected key and the payload against its checksum before the mapping is
+//  handed out, so a truncated, mismatched or corrupt file never is. The
+//  packed cells can be uploaded to a field texture of the same cell size
+//  straight from the mapping.
+//
+//===------------------------------------------------------------------------===
+
+class MappedCheckpoint
+{
+public:
+
+    // • Initialization (throws when missing, mismatched or corrupt)
+    //
+    MappedCheckpoint(const std::filesystem::path& path, const CheckpointKey& key) noexcept(false);
+
+    MappedCheckpoint(MappedCheckpoint&& ) = default;
+    MappedCheckpoint& operator = (MappedCheckpoint&& ) = default;
+
+    // • Accessors
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    constexpr uint32_t cell_size(void) const noexcept
+    {
+        return m_cell_size;
+    }
+
+    constexpr size_t bytes_per_row(void) const noexcept
+    {
+        return size_t{ m_width } * m_cell_size;
+    }
+
+    const uint8_t* data(void) const noexcept
+    {
+        return m_cells;
+    }
+
+    // • Methods : unpack into grid, restoring durations from the rule
+    //
+    void copy_to(Grid& grid, const AutomatRule& rule) const noexcept(false);
+
+private:
+
+    // • Data members
+    //
+    MappedFile          m_file;
+    const uint8_t*      m_cells;
+    uint32_t            m_width;
+    uint32_t            m_height;
+    uint32_t            m_cell_size;
+};
+
+//===------------------------------------------------------------------------===
+//
+// • CheckpointCache
+//
+//  Directory of warm-up checkpoints, one file per key. Entries are written
+//  to a temporary file and renamed into place, so a reader sees either the
+//  previous entry or the complete new one. An entry that fails validation
+//  is removed and reported as a miss.
+//
+//===------------------------------------------------------------------------===
+
+class CheckpointCache
+{
+public:
+
+    // • Initialization (creates the directory)
+    //
+    explicit CheckpointCache(std::filesystem::path directory) noexcept(false);
+
+    // • Accessors
+    //
+    const std::filesystem::path& directory(void) const noexcept
+    {
+        return m_directory;
+    }
+
+    std::filesystem::path path(const CheckpointKey& key) const noexcept(false);
+
+    // • Methods
+    //
+    std::optional<MappedCheckpoint> load(const CheckpointKey& key) const noexcept;
+
+    bool store(const CheckpointKey& key, const void* cells, uint32_t cell_size) const noexcept;
+    bool store(const CheckpointKey& key, const Grid& grid, const AutomatRule& rule) const noexcept;
+
+private:
+
+    // • Data members
+    //
+    std::filesystem::path   m_directory;
+};
+
+} // namespace field
@@ -0,0 +1,173 @@
+//
+//  CycleStepper.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/CycleStepper.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • CycleDetector
+//===------------------------------------------------------------------------===
+
+CycleDetector::CycleDetector(uint32_t max_period) noexcept(false)
+    :
+        m_history( max_period, 0 ),
+        m_next   { 0 },
+        m_count  { 0 }
+{
+    if ( 0 == max_period ) {
+        throw false;
+    }
+}
+
+std::optional<uint32_t> CycleDetector::observe(uint64_t hash) noexcept
+{
+    const auto size   = max_period();
+    auto       period = std::optional<uint32_t>{};
+
+    for ( auto p = uint32_t{ 1 }; p <= m_count; ++p )
+    {
+        if ( hash == m_history[ (m_next + size - p) % size ] )
+        {
+            period = p;
+            break;
+        }
+    }
+
+    m_history[m_next] = hash;
+    m_next            = (m_next + 1u) % size;
+    m_count           = std::min(m_count + 1u, size);
+
+    return period;
+}
+
+//===------------------------------------------------------------------------===
+// • CycleStepper
+//===------------------------------------------------------------------------===
+
+CycleStepper::CycleStepper(const Grid& initial, const AutomatRule& rule, uint32_t max_period) noexcept(false)
+    :
+        m_rule      { rule },
+        m_planes    { initial.width(), initial.height() },
+        m_detector  { max_period },
+        m_generation{ 0 },
+        m_hash      { 0 }
+{
+    // • A cycle of the deterministic masks is no cycle of a stochastic field
+    //
+    if ( is_stochastic(rule) ) {
+        throw false;
+    }
+
+    m_planes.load(initial);
+
+    m_hash = m_planes.hash();
+    m_detector.observe(m_hash);
+}
+
+void CycleStepper::step(void) noexcept(false)
+{
+    // • Replay
+    //
+    if ( m_cycle )
+    {
+        ++m_generation;
+        m_hash = m_hashes[ m_cycle->phase(m_generation) ];
+
+        return;
+    }
+
+    m_hash = m_planes.step_hashed(m_rule, m_hash);
+    ++m_generation;
+
+    const auto period = m_detector.observe(m_hash);
+
+    // • Confirm or reject the candidate once a full period has been stepped
+    //
+    if ( m_candidate )
+    {
+        const auto offset = m_generation - m_candidate->start;
+
+        if ( offset < m_candidate->period )
+        {
+            m_states.emplace_back( m_planes.width(), m_planes.height() );
+            m_planes.store( m_states.back() );
+            m_hashes.push_back(m_hash);
+
+            return;
+        }
+
+        if ( m_hash == m_hashes.front() )
+        {
+            auto state = Grid{ m_planes.width(), m_planes.height() };
+            m_planes.store(state);
+
+            if ( state == m_states.front() )
+            {
+                m_cycle = m_candidate;
+                m_candidate.reset();
+
+                return;
+            }
+        }
+
+        m_candidate.reset();
+        m_states.clear();
+        m_hashes.clear();
+    }
+
+    // • Start confirming a new candidate from this generation
+    //
+    if ( period )
+    {
+        m_candidate = Cycle{ m_generation, *period };
+
+        m_states.emplace_back( m_planes.width(), m_planes.height() );
+        m_planes.store( m_states.back() );
+        m_hashes.push_back(m_hash);
+    }
+}
+
+void CycleStepper::store(Grid& grid) const noexcept(false)
+{
+    if ( m_cycle )
+    {
+        const auto& state = m_states[ m_cycle->phase(m_generation) ];
+
+        if ( grid.width() != state.width() || grid.height() != state.height() ) {
+            throw false;
+        }
+
+        grid = state;
+    }
+    else
+    {
+        m_planes.store(grid);
+    }
+}
+
+} // namespace field
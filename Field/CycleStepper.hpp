@@ -0,0 +1,164 @@
+//
+//  CycleStepper.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/BytePlanes.hpp>
+#include <Field/Grid.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Cycle
+//
+//  The field at generation start + period + i equals the field at
+//  start + i for every i >= 0. A period of one is a steady state. An
+//  exporter can emit generations [start, start + period) as a seamless loop.
+//===------------------------------------------------------------------------===
+
+struct Cycle
+{
+    uint64_t    start;
+    uint32_t    period;
+
+    // • Index into one period of a generation at or after start
+    //
+    constexpr uint32_t phase(uint64_t generation) const noexcept
+    {
+        return static_cast<uint32_t>( (generation - start) % period );
+    }
+};
+
+//===------------------------------------------------------------------------===
+//
+// • CycleDetector
+//
+//  Hashes of the last max_period generations. Each new hash is compared
+//  against the history, nearest first, so the shortest period that repeats
+//  is the one reported. A match is only a candidate until the states
+//  themselves have been compared.
+//
+//===------------------------------------------------------------------------===
+
+class CycleDetector
+{
+public:
+
+    // • Initialization
+    //
+    explicit CycleDetector(uint32_t max_period) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint32_t max_period(void) const noexcept
+    {
+        return static_cast<uint32_t>( m_history.size() );
+    }
+
+    // • Methods : candidate period of the newest hash, if any
+    //
+    std::optional<uint32_t> observe(uint64_t hash) noexcept;
+
+private:
+
+    // • Data members
+    //
+    std::vector<uint64_t>   m_history;      // ring buffer, newest at m_next - 1
+    uint32_t                m_next;
+    uint32_t                m_count;
+};
+
+//===------------------------------------------------------------------------===
+//
+// • CycleStepper
+//
+//  Steps a field while tracking its hash incrementally. When the hash
+//  repeats with period p, the next p states are cached as they are stepped
+//  and compared with the state the candidate started from; if that state
+//  recurs exactly, the cycle is confirmed and further steps replay the
+//  cache instead of stepping. A hash collision fails the comparison and
+//  detection carries on.
+//
+//  The cache holds up to max_period copies of the field.
+//
+//===------------------------------------------------------------------------===
+
+class CycleStepper
+{
+public:
+
+    // • Constants
+    //
+    static constexpr uint32_t default_max_period = 64;
+
+    // • Initialization (throws for a stochastic rule, whose field never
+    //      repeats deterministically)
+    //
+    CycleStepper(const Grid& initial, const AutomatRule& rule,
+                 uint32_t max_period = default_max_period) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint64_t generation(void) const noexcept
+    {
+        return m_generation;
+    }
+
+    constexpr uint64_t hash(void) const noexcept
+    {
+        return m_hash;
+    }
+
+    constexpr const std::optional<Cycle>& cycle(void) const noexcept
+    {
+        return m_cycle;
+    }
+
+    // • Methods
+    //
+    void step(void) noexcept(false);
+    void store(Grid& grid) const noexcept(false);
+
+private:
+
+    // • Data members
+    //
+    AutomatRule             m_rule;
+    BytePlanes              m_planes;
+    CycleDetector           m_detector;
+    uint64_t                m_generation;
+    uint64_t                m_hash;
+
+    std::optional<Cycle>    m_candidate;    // being confirmed
+    std::optional<Cycle>    m_cycle;        // confirmed
+    std::vector<Grid>       m_states;       // start, start + 1, ... (one period)
+    std::vector<uint64_t>   m_hashes;       // hashes of m_states
+};
+
+} // namespace field
@@ -0,0 +1,349 @@
+//
+//  DeltaCodec.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/DeltaCodec.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+// • Longest base-128 varint of a 64-bit count
+//
+constexpr size_t max_varint_length = 10;
+
+uint8_t* put_varint(uint8_t* destination, uint64_t value) noexcept
+{
+    for ( ; 0x80u <= value; value >>= 7 ) {
+        *destination++ = static_cast<uint8_t>( (value & 0x7fu) | 0x80u );
+    }
+
+    *destination++ = static_cast<uint8_t>(value);
+
+    return destination;
+}
+
+uint64_t get_varint(const uint8_t*& source, const uint8_t* end) noexcept(false)
+{
+    auto value = uint64_t{ 0 };
+
+    for ( auto shift = 0u; ; shift += 7u )
+    {
+        if ( end <= source || 63u < shift ) {
+            throw false;
+        }
+
+        const auto byte = *source++;
+        value |= uint64_t{ byte & 0x7fu } << shift;
+
+        if ( 0 == ( byte & 0x80u ) ) {
+            return value;
+        }
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • DeltaWords
+//
+//  The XOR of the cells against the previous frame, a word at a time. The
+//  final word may be short, and is then read through a zero-padded copy.
+//  Without a previous frame the words are the cells themselves.
+//===------------------------------------------------------------------------===
+
+template <bool Previous_>
+class DeltaWords
+{
+public:
+
+    DeltaWords(const uint8_t* previous, const uint8_t* cells, size_t length) noexcept
+        :
+            m_previous{ previous           },
+            m_cells   { cells              },
+            m_length  { length             },
+            m_full    { length / 8u        },
+            m_count   { (length + 7u) / 8u }
+    {
+    }
+
+    size_t count(void) const noexcept
+    {
+        return m_count;
+    }
+
+    uint64_t operator [] (size_t word) const noexcept
+    {
+        return ( word < m_full ) ? delta(word * 8u, 8) : delta(word * 8u, m_length - word * 8u);
+    }
+
+    // • First word at or after the given one that has changed
+    //
+    size_t next_changed(size_t word) const noexcept
+    {
+        // • Four words at a time across unchanged stretches, which
+        //      vectorizes to wide compares
+        //
+        for ( ; word + 4u <= m_full; word += 4u )
+        {
+            const auto offset = word * 8u;
+
+            const auto changed = delta(offset,       8) | delta(offset +  8u, 8)
+                               | delta(offset + 16u, 8) | delta(offset + 24u, 8);
+            if ( 0 != changed ) {
+                break;
+            }
+        }
+
+        while ( word < m_count && 0 == (*this)[word] ) {
+            ++word;
+        }
+
+        return word;
+    }
+
+    // • First word at or after the given one that is unchanged
+    //
+    size_t next_unchanged(size_t word) const noexcept
+    {
+        while ( word < m_count && 0 != (*this)[word] ) {
+            ++word;
+        }
+
+        return word;
+    }
+
+    // • XOR bytes of the words from begin up to end
+    //
+    void store(size_t begin, size_t end, uint8_t* destination) const noexcept
+    {
+        auto word = begin;
+
+        for ( ; word < std::min(end, m_full); ++word, destination += 8 )
+        {
+            const auto value = delta(word * 8u, 8);
+            std::memcpy(destination, &value, 8);
+        }
+
+        if ( word < end )
+        {
+            const auto value = (*this)[word];
+            std::memcpy(destination, &value, m_length - word * 8u);
+        }
+    }
+
+private:
+
+    uint64_t delta(size_t offset, size_t length) const noexcept
+    {
+        auto cells    = uint64_t{ 0 };
+        auto previous = uint64_t{ 0 };
+
+        std::memcpy(&cells, m_cells + offset, length);
+
+        if constexpr ( Previous_ ) {
+            std::memcpy(&previous, m_previous + offset, length);
+        }
+
+        return cells ^ previous;
+    }
+
+    const uint8_t*  m_previous;
+    const uint8_t*  m_cells;
+    size_t          m_length;
+    size_t          m_full;
+    size_t          m_count;
+};
+
+// • Appends the tokens of the changed runs, copying the changed words over
+//      update when it is not null
+//
+template <bool Previous_>
+void encode_words(const uint8_t* previous, const uint8_t* cells, size_t length,
+                  std::vector<uint8_t>& buffer, uint8_t* update) noexcept(false)
+{
+    const auto words = DeltaWords<Previous_>{ previous, cells, length };
+    auto       used  = buffer.size();
+    auto       start = size_t{ 0 };
+
+    for ( ; ; )
+    {
+        const auto begin = words.next_changed(start);
+
+        // • Trailing unchanged words need no token
+        //
+        if ( words.count() <= begin ) {
+            break;
+        }
+
+        const auto end   = words.next_unchanged(begin + 1u);
+        const auto bytes = std::min(end * 8u, length) - begin * 8u;
+
+        // • Room for the token, growing geometrically
+        //
+        const auto needed = used + 2u * max_varint_length + bytes;
+
+        if ( buffer.size() < needed ) {
+            buffer.resize( std::max(needed, 2u * buffer.size()) );
+        }
+
+        auto* destination = put_varint(buffer.data() + used, begin - start);
+        destination       = put_varint(destination, end - begin);
+
+        words.store(begin, end, destination);
+
+        if ( nullptr != update ) {
+            std::memcpy(update + begin * 8u, cells + begin * 8u, bytes);
+        }
+
+        used  = static_cast<size_t>( destination - buffer.data() ) + bytes;
+        start = end;
+    }
+
+    buffer.resize(used);
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Delta frames
+//===------------------------------------------------------------------------===
+
+void encode_delta(const void* previous, const void* cells, size_t length,
+                  std::vector<uint8_t>& buffer) noexcept(false)
+{
+    const auto* previous_bytes = static_cast<const uint8_t*>(previous);
+    const auto* cell_bytes     = static_cast<const uint8_t*>(cells);
+
+    if ( nullptr != previous_bytes ) {
+        encode_words<true>(previous_bytes, cell_bytes, length, buffer, nullptr);
+    } else {
+        encode_words<false>(nullptr, cell_bytes, length, buffer, nullptr);
+    }
+}
+
+void apply_delta(const uint8_t* source, size_t source_length, void* cells, size_t length) noexcept(false)
+{
+    const auto* end         = source + source_length;
+    auto*       destination = static_cast<uint8_t*>(cells);
+    const auto  words       = (length + 7u) / 8u;
+    auto        word        = size_t{ 0 };
+
+    while ( source < end )
+    {
+        const auto unchanged = get_varint(source, end);
+
+        if ( words - word < unchanged ) {
+            throw false;
+        }
+
+        word += unchanged;
+
+        const auto changed = get_varint(source, end);
+
+        if ( 0 == changed || words - word < changed ) {
+            throw false;
+        }
+
+        const auto offset = word * 8u;
+        const auto bytes  = std::min( ( word + changed ) * 8u, length ) - offset;
+
+        if ( static_cast<size_t>( end - source ) < bytes ) {
+            throw false;
+        }
+
+        // • Unchanged words are already in place; changed ones flip
+        //
+        auto i = size_t{ 0 };
+
+        for ( ; i + 8u <= bytes; i += 8u )
+        {
+            auto value = uint64_t{ 0 };
+            auto delta = uint64_t{ 0 };
+
+            std::memcpy(&value, destination + offset + i, 8);
+            std::memcpy(&delta, source + i, 8);
+
+            value ^= delta;
+            std::memcpy(destination + offset + i, &value, 8);
+        }
+
+        for ( ; i < bytes; ++i ) {
+            destination[offset + i] ^= source[i];
+        }
+
+        source += bytes;
+        word   += changed;
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • DeltaEncoder
+//===------------------------------------------------------------------------===
+
+DeltaEncoder::DeltaEncoder(size_t length) noexcept(false)
+    :
+        m_previous( length, 0 )
+{
+}
+
+void DeltaEncoder::encode(const void* cells, std::vector<uint8_t>& buffer) noexcept(false)
+{
+    buffer.clear();
+
+    encode_words<true>(m_previous.data(), static_cast<const uint8_t*>(cells), m_previous.size(),
+                       buffer, m_previous.data());
+}
+
+void DeltaEncoder::reset(void) noexcept
+{
+    std::fill(m_previous.begin(), m_previous.end(), 0);
+}
+
+//===------------------------------------------------------------------------===
+// • DeltaDecoder
+//===------------------------------------------------------------------------===
+
+DeltaDecoder::DeltaDecoder(size_t length) noexcept(false)
+    :
+        m_cells( length, 0 )
+{
+}
+
+void DeltaDecoder::decode(const uint8_t* source, size_t source_length) noexcept(false)
+{
+    apply_delta(source, source_length, m_cells.data(), m_cells.size());
+}
+
+void DeltaDecoder::reset(void) noexcept
+{
+    std::fill(m_cells.begin(), m_cells.end(), 0);
+}
+
+} // namespace field
@@ -0,0 +1,134 @@
+//
+//  DeltaCodec.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Delta frames
+//
+//  A frame of packed cells stored as its XOR against the previous frame,
+//  compared eight bytes at a time. Each run of changed words is a token: a
+//  base-128 varint count of unchanged words, a varint count of changed
+//  words and then their XOR bytes. A final word shorter than eight bytes
+//  is stored at its own length. Unchanged words cost nothing to decode, as
+//  a frame is applied in place over its predecessor, so both directions
+//  run at memory speed over settled fields. Against no previous frame the
+//  runs of dead cells encode as unchanged words.
+//===------------------------------------------------------------------------===
+
+// • Appends the delta of length bytes of cells from previous, or from zeros
+//      when previous is null
+//
+void encode_delta(const void* previous, const void* cells, size_t length,
+                  std::vector<uint8_t>& buffer) noexcept(false);
+
+// • Applies a delta to length bytes of cells holding its previous frame, or
+//      zeros (throws when malformed)
+//
+void apply_delta(const uint8_t* source, size_t source_length, void* cells, size_t length) noexcept(false);
+
+//===------------------------------------------------------------------------===
+//
+// • DeltaEncoder
+//
+//  Encodes a sequence of frames of the same length, each against the one
+//  before, starting from zeros. Only the changed words of the previous
+//  frame are updated, so unchanged stretches are read once per frame.
+//
+//===------------------------------------------------------------------------===
+
+class DeltaEncoder
+{
+public:
+
+    // • Initialization
+    //
+    explicit DeltaEncoder(size_t length) noexcept(false);
+
+    // • Accessors
+    //
+    size_t length(void) const noexcept
+    {
+        return m_previous.size();
+    }
+
+    // • Methods (replace the buffer's contents with the next frame's delta)
+    //
+    void encode(const void* cells, std::vector<uint8_t>& buffer) noexcept(false);
+    void reset(void) noexcept;
+
+private:
+
+    // • Data members
+    //
+    std::vector<uint8_t>    m_previous;
+};
+
+//===------------------------------------------------------------------------===
+//
+// • DeltaDecoder
+//
+//  Rebuilds the frames of a DeltaEncoder's sequence, in order
+//
+//===------------------------------------------------------------------------===
+
+class DeltaDecoder
+{
+public:
+
+    // • Initialization
+    //
+    explicit DeltaDecoder(size_t length) noexcept(false);
+
+    // • Accessors
+    //
+    size_t length(void) const noexcept
+    {
+        return m_cells.size();
+    }
+
+    const uint8_t* cells(void) const noexcept
+    {
+        return m_cells.data();
+    }
+
+    // • Methods (throw when malformed, leaving the cells undefined)
+    //
+    void decode(const uint8_t* source, size_t source_length) noexcept(false);
+    void reset(void) noexcept;
+
+private:
+
+    // • Data members
+    //
+    std::vector<uint8_t>    m_cells;
+};
+
+} // namespace field
@@ -0,0 +1,503 @@
+//
+//  EventLog.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/EventLog.hpp>
+#include <Field/BytePlanes.hpp>
+#include <Field/Checkpoint.hpp>
+#include <Field/Keyframes.hpp>
+#include <Field/Step.hpp>
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+enum : uint32_t
+{
+    event_log_magic   = 0x54586576, // 'TXev'
+    event_log_version = 1
+};
+
+// • Records are written out once this much has been buffered
+//
+constexpr size_t flush_length = size_t{ 1 } << 20;
+
+// • The events among eight cells, indexed by a bit per cell: the first and
+//      last cells with an event, and the gaps from each event to the next,
+//      a byte each
+//
+struct WordEvents
+{
+    uint64_t    gaps;
+    uint8_t     first;
+    uint8_t     last;
+    uint8_t     gap_count;
+};
+
+constexpr auto word_events = []
+{
+    auto table = std::array<WordEvents, 256>{};
+
+    for ( auto mask = 1u; mask < 256u; ++mask )
+    {
+        auto& entry = table[mask];
+
+        entry.first = static_cast<uint8_t>( std::countr_zero(mask) );
+        entry.last  = entry.first;
+
+        for ( auto cell = entry.first + 1u; cell < 8u; ++cell )
+        {
+            if ( 0 != ( mask & (1u << cell) ) )
+            {
+                entry.gaps |= uint64_t{ cell - entry.last } << (8u * entry.gap_count++);
+                entry.last  = static_cast<uint8_t>(cell);
+            }
+        }
+    }
+
+    return table;
+}();
+
+uint8_t* put_varint(uint8_t* destination, uint64_t value) noexcept
+{
+    for ( ; 0x80u <= value; value >>= 7 ) {
+        *destination++ = static_cast<uint8_t>( (value & 0x7fu) | 0x80u );
+    }
+
+    *destination++ = static_cast<uint8_t>(value);
+
+    return destination;
+}
+
+uint64_t get_varint(const uint8_t*& source, const uint8_t* end) noexcept(false)
+{
+    auto value = uint64_t{ 0 };
+
+    for ( auto shift = 0u; ; shift += 7u )
+    {
+        if ( end <= source || 63u < shift ) {
+            throw false;
+        }
+
+        const auto byte = *source++;
+        value |= uint64_t{ byte & 0x7fu } << shift;
+
+        if ( 0 == ( byte & 0x80u ) ) {
+            return value;
+        }
+    }
+}
+
+// • The header of a mapped log, once its layout and checksum are valid
+//
+EventLogHeader read_header(const MappedFile& file) noexcept(false)
+{
+    const auto length = file.size();
+
+    if ( length < sizeof(EventLogHeader) ) {
+        throw false;
+    }
+
+    auto header = EventLogHeader{};
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    const auto payload = length - sizeof(EventLogHeader);
+
+    const auto valid = event_log_magic   == header.magic
+                    && event_log_version == header.version
+                    && 0 == header.reserved
+                    && 0 != header.width && 0 != header.height
+                    && header.base_length <= payload
+                    && payload - header.base_length >= header.count
+                    && checksum(file.data() + sizeof(EventLogHeader), payload) == header.checksum;
+
+    if ( !valid ) {
+        throw false;
+    }
+
+    return header;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • EventLogWriter
+//===------------------------------------------------------------------------===
+
+EventLogWriter::EventLogWriter(std::filesystem::path path, const Grid& base, const AutomatRule& rule,
+                               uint64_t base_generation) noexcept(false)
+    :
+        m_path       { std::move(path)        },
+        m_temp_path  { temporary_path(m_path) },
+        m_descriptor { -1                     },
+        m_header     {
+            .magic           = event_log_magic,
+            .version         = event_log_version,
+            .width           = base.width(),
+            .height          = base.height(),
+            .rule            = rule,
+            .reserved        = 0,
+            .base_generation = base_generation,
+            .base_length     = 0,
+            .count           = 0,
+            .checksum        = 0
+        },
+        m_event_count{ 0                      },
+        m_alive      ( base.size()            ),
+        m_changes    ( base.size()            )
+{
+    const auto* values = base.data();
+
+    for ( auto i = size_t{ 0 }; i < m_alive.size(); ++i ) {
+        m_alive[i] = values[i].alive;
+    }
+
+    encode_runs(base, m_buffer);
+
+    m_header.base_length = m_buffer.size();
+
+    m_descriptor = ::open(m_temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if ( m_descriptor < 0 ) {
+        throw false;
+    }
+
+    // • Placeholder header until finish() knows the count and checksum
+    //
+    if ( !write_all(m_descriptor, &m_header, sizeof(m_header)) )
+    {
+        ::close(m_descriptor);
+        ::unlink(m_temp_path.c_str());
+        throw false;
+    }
+}
+
+EventLogWriter::~EventLogWriter(void) noexcept
+{
+    if ( 0 <= m_descriptor )
+    {
+        ::close(m_descriptor);
+        ::unlink(m_temp_path.c_str());
+    }
+}
+
+void EventLogWriter::record(const Grid& grid) noexcept(false)
+{
+    if ( m_descriptor < 0 || grid.width() != m_header.width || grid.height() != m_header.height ) {
+        throw false;
+    }
+
+    // • A cell's alive state only changes when it enters growth or decline
+    //
+    const auto* values  = grid.data();
+    auto*       alive   = m_alive.data();
+    auto*       changes = m_changes.data();
+    const auto  count   = m_alive.size();
+
+    for ( auto i = size_t{ 0 }; i < count; ++i )
+    {
+        const auto next_alive = values[i].alive;
+
+        changes[i] = next_alive ^ alive[i];
+        alive[i]   = next_alive;
+    }
+
+    encode(changes);
+}
+
+void EventLogWriter::record(const std::vector<uint8_t>& changes) noexcept(false)
+{
+    if ( m_descriptor < 0 || changes.size() != m_alive.size() ) {
+        throw false;
+    }
+
+    auto*       alive   = m_alive.data();
+    const auto* changed = changes.data();
+    const auto  count   = m_alive.size();
+
+    auto i = size_t{ 0 };
+
+    for ( ; i + 8u <= count; i += 8u )
+    {
+        auto word      = uint64_t{ 0 };
+        auto next_word = uint64_t{ 0 };
+
+        std::memcpy(&word, alive + i, 8);
+        std::memcpy(&next_word, changed + i, 8);
+
+        next_word ^= word;
+        std::memcpy(alive + i, &next_word, 8);
+    }
+
+    for ( ; i < count; ++i ) {
+        alive[i] ^= changed[i];
+    }
+
+    encode(changed);
+}
+
+// • Scans the changes eight at a time, skipping the settled stretches
+//      between events. The change bytes of a word gather into one bit each,
+//      and the table gives all the gaps within the word at once, so only
+//      the gap from the previous word is encoded.
+//
+void EventLogWriter::encode(const uint8_t* changes) noexcept(false)
+{
+    const auto count = m_alive.size();
+
+    // • No gap takes more bytes than the cells it spans, so a record fits in
+    //      a byte per cell and its end marker, and the gaps of a word are
+    //      copied as a whole eight bytes
+    //
+    const auto start = m_buffer.size();
+
+    m_buffer.resize(start + count + 1u + 8u);
+
+    auto* destination = m_buffer.data() + start;
+    auto  next        = size_t{ 0 };
+    auto  events      = uint64_t{ 0 };
+
+    auto block = size_t{ 0 };
+
+    for ( ; block + 8u <= count; block += 8u )
+    {
+        auto word = uint64_t{ 0 };
+        std::memcpy(&word, changes + block, 8);
+
+        if ( 0 != word )
+        {
+            const auto& entry = word_events[ (word * 0x0102040810204080ull) >> 56 ];
+
+            destination = put_varint(destination, block + entry.first - next + 1u);
+
+            std::memcpy(destination, &entry.gaps, sizeof(entry.gaps));
+            destination += entry.gap_count;
+
+            next    = block + entry.last + 1u;
+            events += 1u + entry.gap_count;
+        }
+    }
+
+    for ( ; block < count; ++block )
+    {
+        if ( 0 != changes[block] )
+        {
+            destination = put_varint(destination, block - next + 1u);
+            next        = block + 1u;
+
+            ++events;
+        }
+    }
+
+    *destination++ = 0;
+
+    m_buffer.resize( static_cast<size_t>( destination - m_buffer.data() ) );
+
+    m_event_count += events;
+    ++m_header.count;
+
+    if ( flush_length <= m_buffer.size() ) {
+        flush();
+    }
+}
+
+void EventLogWriter::flush(void) noexcept(false)
+{
+    if ( !write_all(m_descriptor, m_buffer.data(), m_buffer.size()) ) {
+        throw false;
+    }
+
+    m_buffer.clear();
+}
+
+void EventLogWriter::finish(void) noexcept(false)
+{
+    if ( m_descriptor < 0 ) {
+        throw false;
+    }
+
+    flush();
+
+    // • Checksum the payload as written, through a mapping of the file
+    //
+    {
+        const auto file = MappedFile{ m_temp_path };
+
+        m_header.checksum = checksum(file.data() + sizeof(EventLogHeader), file.size() - sizeof(EventLogHeader));
+    }
+
+    if ( static_cast<ssize_t>( sizeof(m_header) ) != ::pwrite(m_descriptor, &m_header, sizeof(m_header), 0) ) {
+        throw false;
+    }
+
+    const auto result = ::close(m_descriptor);
+    m_descriptor = -1;
+
+    if ( 0 != result || 0 != ::rename(m_temp_path.c_str(), m_path.c_str()) )
+    {
+        ::unlink(m_temp_path.c_str());
+        throw false;
+    }
+}
+
+void write_event_log(const std::filesystem::path& path, const Grid& initial, const AutomatRule& rule,
+                     uint64_t generations) noexcept(false)
+{
+    auto writer = EventLogWriter{ path, initial, rule };
+
+    // • BytePlanes only steps a rule's deterministic masks, so a stochastic
+    //      rule steps by the reference, whose generation keys the draws
+    //
+    if ( is_stochastic(rule) )
+    {
+        auto grid = initial;
+        auto next = initial;
+
+        for ( auto generation = uint64_t{ 0 }; generation < generations; ++generation )
+        {
+            step(grid, next, rule, generation);
+            std::swap(grid, next);
+            writer.record(grid);
+        }
+    }
+    else
+    {
+        // • The planes mark the changed cells as they step, so no grid is
+        //      stored or compared
+        //
+        auto planes  = BytePlanes{ initial.width(), initial.height() };
+        auto changes = std::vector<uint8_t>{};
+
+        planes.load(initial);
+
+        for ( auto generation = uint64_t{ 0 }; generation < generations; ++generation )
+        {
+            planes.step_changes(rule, changes);
+            writer.record(changes);
+        }
+    }
+
+    writer.finish();
+}
+
+//===------------------------------------------------------------------------===
+// • EventLogPlayer
+//===------------------------------------------------------------------------===
+
+EventLogPlayer::EventLogPlayer(const std::filesystem::path& path) noexcept(false)
+    :
+        m_file    { path                            },
+        m_header  { read_header(m_file)             },
+        m_grid    { m_header.width, m_header.height },
+        m_cursor  { nullptr                         },
+        m_position{ 0                               }
+{
+    rewind();
+}
+
+void EventLogPlayer::rewind(void) noexcept(false)
+{
+    const auto* base = m_file.data() + sizeof(EventLogHeader);
+
+    decode_runs(base, m_header.base_length, m_grid);
+
+    m_cursor   = base + m_header.base_length;
+    m_position = 0;
+}
+
+void EventLogPlayer::next(void) noexcept(false)
+{
+    if ( m_header.count <= m_position ) {
+        throw false;
+    }
+
+    auto*       values = m_grid.data();
+    const auto  count  = m_grid.size();
+    const auto* end    = m_file.data() + m_file.size();
+
+    // • Transitioning cells count down, branch-free so the pass vectorizes
+    //
+    for ( auto i = size_t{ 0 }; i < count; ++i ) {
+        values[i].step -= ( 0 != values[i].step );
+    }
+
+    // • Settled cells with an event enter growth or decline
+    //
+    for ( auto i = size_t{ 0 }; ; ++i )
+    {
+        const auto gap = get_varint(m_cursor, end);
+
+        if ( 0 == gap ) {
+            break;
+        }
+
+        if ( count - i < gap ) {
+            throw false;
+        }
+
+        i += gap - 1u;
+
+        auto& value = values[i];
+
+        if ( 0 != value.step ) {
+            throw false;
+        }
+
+        value.alive = value.alive ? 0 : 1;
+        value.step  = value.duration = value.alive ? m_header.rule.growth_duration
+                                                   : m_header.rule.decline_duration;
+
+    }
+
+    ++m_position;
+}
+
+void EventLogPlayer::seek(uint64_t generation) noexcept(false)
+{
+    if ( generation < base_generation() || last_generation() < generation ) {
+        throw false;
+    }
+
+    if ( generation < this->generation() ) {
+        rewind();
+    }
+
+    while ( this->generation() < generation ) {
+        next();
+    }
+}
+
+} // namespace field
@@ -0,0 +1,214 @@
+//
+//  EventLog.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/MappedFile.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <type_traits>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Event log file layout
+//
+//  [EventLogHeader] [base snapshot] [generation record × count]
+//
+//  The base is a run-length snapshot of the field at base_generation. Each
+//  generation record lists the cells that entered growth or decline in that
+//  generation as base-128 varints of the gap to the previous event plus
+//  one, ending with a zero. Every other cell only counts down its step, so
+//  the events and the rule's durations rebuild the field exactly, whatever
+//  the rule's neighborhood or chances. The checksum covers everything after
+//  the header.
+//===------------------------------------------------------------------------===
+
+struct EventLogHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    width;
+    uint32_t    height;
+    AutomatRule rule;
+    uint32_t    reserved;       // zero, aligning the counts
+    uint64_t    base_generation;
+    uint64_t    base_length;
+    uint64_t    count;
+    uint64_t    checksum;
+};
+
+// • Written as laid out in memory, so no byte may be padding
+//
+static_assert( 80 == sizeof(EventLogHeader), "Unexpected size" );
+static_assert( std::has_unique_object_representations_v<EventLogHeader>, "Unexpected padding" );
+
+//===------------------------------------------------------------------------===
+//
+// • EventLogWriter
+//
+//  Records the events of each generation of a field being stepped, from
+//  the cells an engine marks as changed, or from whole grids, compared with
+//  one alive byte kept per cell. Records are buffered and the file is
+//  written under a temporary name, only appearing at its path once finish()
+//  has written the header.
+//
+//===------------------------------------------------------------------------===
+
+class EventLogWriter
+{
+public:
+
+    // • Initialization
+    //
+    EventLogWriter(std::filesystem::path path, const Grid& base, const AutomatRule& rule,
+                   uint64_t base_generation = 0) noexcept(false);
+    ~EventLogWriter(void) noexcept;
+
+    EventLogWriter(const EventLogWriter& ) = delete;
+    EventLogWriter& operator = (const EventLogWriter& ) = delete;
+
+    // • Accessors
+    //
+    constexpr uint64_t generation(void) const noexcept
+    {
+        return m_header.base_generation + m_header.count;
+    }
+
+    constexpr uint64_t event_count(void) const noexcept
+    {
+        return m_event_count;
+    }
+
+    // • Methods (each grid or set of changes is the generation after the
+    //      last recorded; changes holds a one for each cell whose alive state
+    //      changed and a zero elsewhere, a byte per cell in raster order)
+    //
+    void record(const Grid& grid) noexcept(false);
+    void record(const std::vector<uint8_t>& changes) noexcept(false);
+    void finish(void) noexcept(false);
+
+private:
+
+    void encode(const uint8_t* changes) noexcept(false);
+    void flush(void) noexcept(false);
+
+    // • Data members
+    //
+    std::filesystem::path   m_path;
+    std::filesystem::path   m_temp_path;
+    int                     m_descriptor;
+    EventLogHeader          m_header;
+    uint64_t                m_event_count;
+    std::vector<uint8_t>    m_alive;
+    std::vector<uint8_t>    m_changes;
+    std::vector<uint8_t>    m_buffer;
+};
+
+// • Steps the field from generation 0 and records every generation up to
+//      and including the last; a stochastic rule steps by the slower scalar
+//      reference so that its draws match the renderer's
+//
+void write_event_log(const std::filesystem::path& path, const Grid& initial, const AutomatRule& rule,
+                     uint64_t generations) noexcept(false);
+
+//===------------------------------------------------------------------------===
+//
+// • EventLogPlayer
+//
+//  Read-only mapping of an event log that rebuilds the field of any logged
+//  generation from the base. Replaying a generation counts down steps and
+//  applies its events, with no neighbors counted, so it runs ahead of
+//  stepping. Seeking backwards replays from the base again.
+//
+//===------------------------------------------------------------------------===
+
+class EventLogPlayer
+{
+public:
+
+    // • Initialization (throws when missing, malformed or corrupt)
+    //
+    explicit EventLogPlayer(const std::filesystem::path& path) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_header.width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_header.height;
+    }
+
+    constexpr const AutomatRule& rule(void) const noexcept
+    {
+        return m_header.rule;
+    }
+
+    constexpr uint64_t base_generation(void) const noexcept
+    {
+        return m_header.base_generation;
+    }
+
+    constexpr uint64_t last_generation(void) const noexcept
+    {
+        return m_header.base_generation + m_header.count;
+    }
+
+    constexpr uint64_t generation(void) const noexcept
+    {
+        return m_header.base_generation + m_position;
+    }
+
+    const Grid& grid(void) const noexcept
+    {
+        return m_grid;
+    }
+
+    // • Methods (throw on a corrupt record or a generation not logged)
+    //
+    void rewind(void) noexcept(false);
+    void next(void) noexcept(false);
+    void seek(uint64_t generation) noexcept(false);
+
+private:
+
+    // • Data members
+    //
+    MappedFile          m_file;
+    EventLogHeader      m_header;
+    Grid                m_grid;
+    const uint8_t*      m_cursor;
+    uint64_t            m_position;
+};
+
+} // namespace field
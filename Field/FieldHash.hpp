@@ -0,0 +1,79 @@
+//
+//  FieldHash.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Shaders/Data/FieldValue.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Field hash
+//
+//  XOR over every cell of a 64-bit hash of its index and value, so a step
+//  updates the hash by XORing out the old and in the new hash of each cell
+//  that changed. A quiescent cell hashes to zero, which makes the hash of
+//  an empty field zero and lets a full computation skip settled regions.
+//===------------------------------------------------------------------------===
+
+constexpr uint64_t cell_hash(size_t index, uint8_t alive, uint8_t step, uint8_t duration) noexcept
+{
+    const auto packed = uint32_t{ alive } | ( uint32_t{ step } << 8 ) | ( uint32_t{ duration } << 16 );
+
+    if ( 0 == packed ) {
+        return 0;
+    }
+
+    // • splitmix64 finalizer
+    //
+    auto value = ( uint64_t{ index } << 24 | packed ) + 0x9e3779b97f4a7c15;
+
+    value = ( value ^ (value >> 30) ) * 0xbf58476d1ce4e5b9;
+    value = ( value ^ (value >> 27) ) * 0x94d049bb133111eb;
+
+    return value ^ (value >> 31);
+}
+
+constexpr uint64_t cell_hash(size_t index, const FieldValue& value) noexcept
+{
+    return cell_hash(index, value.alive, value.step, value.duration);
+}
+
+inline uint64_t field_hash(const Grid& grid) noexcept
+{
+    auto hash = uint64_t{ 0 };
+
+    for ( auto i = size_t{ 0 }; i < grid.size(); ++i )
+    {
+        hash ^= cell_hash(i, grid.data()[i]);
+    }
+
+    return hash;
+}
+
+} // namespace field
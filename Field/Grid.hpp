@@ -0,0 +1,165 @@
+//
+//  Grid.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Shaders/Data/FieldValue.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • FieldRegion
+//
+//  Cells [left, right) x [top, bottom) of a field: the layout of a
+//  geometry::Region, declared here so that the field engines build without
+//  the simd headers of Graphics/Geometry.hpp
+//===------------------------------------------------------------------------===
+
+struct FieldRegion
+{
+    uint32_t    left;
+    uint32_t    top;
+    uint32_t    right;
+    uint32_t    bottom;
+};
+
+//===------------------------------------------------------------------------===
+//
+// • Grid
+//
+//  Host copy of a field: row-major FieldValues with no row padding, packed
+//  to and unpacked from field texture contents by CellPacking.hpp
+//
+//===------------------------------------------------------------------------===
+
+class Grid
+{
+public:
+
+    // • Initialization
+    //
+    Grid(uint32_t width, uint32_t height) noexcept(false)
+        :
+            m_width { width  },
+            m_height{ height },
+            m_values( size_t{ width } * height, FieldValue{ 0, 0, 0, 0 } )
+    {
+        if ( 0 == width || 0 == height ) {
+            throw false;
+        }
+    }
+
+    Grid(const Grid& ) = default;
+    Grid(Grid&& ) = default;
+
+    // • Assignment
+    //
+    Grid& operator = (const Grid& ) = default;
+    Grid& operator = (Grid&& ) = default;
+
+    // • Comparison
+    //
+    bool operator == (const Grid& ) const noexcept = default;
+
+    // • Accessors : dimensions
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    size_t size(void) const noexcept
+    {
+        return m_values.size();
+    }
+
+    // • Accessors : values
+    //
+    FieldValue* data(void) noexcept
+    {
+        return m_values.data();
+    }
+
+    const FieldValue* data(void) const noexcept
+    {
+        return m_values.data();
+    }
+
+    FieldValue* row(uint32_t y) noexcept
+    {
+        assert( y < m_height );
+
+        return m_values.data() + size_t{ y } * m_width;
+    }
+
+    const FieldValue* row(uint32_t y) const noexcept
+    {
+        assert( y < m_height );
+
+        return m_values.data() + size_t{ y } * m_width;
+    }
+
+    FieldValue& at(uint32_t x, uint32_t y) noexcept
+    {
+        assert( x < m_width );
+
+        return row(y)[x];
+    }
+
+    const FieldValue& at(uint32_t x, uint32_t y) const noexcept
+    {
+        assert( x < m_width );
+
+        return row(y)[x];
+    }
+
+    // • Accessors : toroidal
+    //
+    const FieldValue& wrapped(int64_t x, int64_t y) const noexcept
+    {
+        const auto wx = static_cast<uint32_t>( (x % m_width  + m_width)  % m_width  );
+        const auto wy = static_cast<uint32_t>( (y % m_height + m_height) % m_height );
+
+        return at(wx, wy);
+    }
+
+private:
+
+    // • Data members
+    //
+    uint32_t                m_width;
+    uint32_t                m_height;
+    std::vector<FieldValue> m_values;
+};
+
+} // namespace field
@@ -0,0 +1,513 @@
+//
+//  HashLife.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/HashLife.hpp>
+#include <Field/BytePlanes.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <bit>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+constexpr uint32_t invalid_id = ~uint32_t{ 0 };
+
+// • A jump may create one node per this many cells that stepping directly
+//      would visit
+//
+constexpr uint32_t direct_cells_per_node = 4096;
+
+// • Thrown by successor once a jump has spent its node budget
+//
+struct NodeBudgetSpent
+{
+};
+
+// • Quadrants
+//
+enum : uint32_t
+{
+    nw = 0,
+    ne = 1,
+    sw = 2,
+    se = 3
+};
+
+constexpr uint32_t pack(FieldValue value) noexcept
+{
+    return ( value.alive ? 1u : 0u ) | ( uint32_t{ value.step } << 8 ) | ( uint32_t{ value.duration } << 16 );
+}
+
+constexpr FieldValue unpack(uint32_t packed) noexcept
+{
+    return {
+        .alive    = static_cast<uint8_t>( packed & 0xff ),
+        .step     = static_cast<uint8_t>( (packed >> 8) & 0xff ),
+        .duration = static_cast<uint8_t>( (packed >> 16) & 0xff ),
+        .reserved = 0
+    };
+}
+
+constexpr uint64_t mix(uint64_t value) noexcept
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+
+    return value;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+HashLife::HashLife(uint32_t width, uint32_t height, const AutomatRule& rule, size_t node_limit) noexcept(false)
+    :
+        m_width     { width  },
+        m_height    { height },
+        m_level     { 0      },
+        m_rule      { rule   },
+        m_can_skip  { !is_born(rule, 0) },
+        m_node_limit{ node_limit },
+        m_node_budget{ node_limit },
+        m_field     { invalid_id },
+        m_generation{ 0      }
+{
+    if ( !std::has_single_bit(width) || !std::has_single_bit(height)
+      || is_larger_than_life(rule) || !is_moore(rule) || !is_torus(rule) || is_stochastic(rule) ) {
+        throw false;
+    }
+
+    m_level = static_cast<uint32_t>( std::countr_zero( std::max(width, height) ) );
+
+    // • Empty field
+    //
+    m_field = leaf( FieldValue{ 0, 0, 0, 0 } );
+
+    for ( auto level = uint32_t{ 0 }; level < m_level; ++level ) {
+        m_field = node(m_field, m_field, m_field, m_field);
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Nodes
+//===------------------------------------------------------------------------===
+
+size_t HashLife::NodeKeyHash::operator () (const NodeKey& key) const noexcept
+{
+    auto hash = uint64_t{ key[4] };
+
+    for ( auto index = 0u; index < 4u; ++index ) {
+        hash = mix( hash ^ ( uint64_t{ key[index] } + 0x9e3779b97f4a7c15ull * (index + 1u) ) );
+    }
+
+    return static_cast<size_t>(hash);
+}
+
+HashLife::NodeID HashLife::leaf(FieldValue value) noexcept(false)
+{
+    const auto packed = pack(value);
+    const auto key    = NodeKey{ packed, invalid_id, invalid_id, invalid_id, 0 };
+
+    return intern( key, Node {
+        .children  = { packed, invalid_id, invalid_id, invalid_id },
+        .level     = 0,
+        .quiescent = ( 0 == value.alive && 0 == value.step )
+    });
+}
+
+HashLife::NodeID HashLife::node(NodeID nw_id, NodeID ne_id, NodeID sw_id, NodeID se_id) noexcept(false)
+{
+    const auto level = m_nodes[nw_id].level + 1u;
+    const auto key   = NodeKey{ nw_id, ne_id, sw_id, se_id, level };
+
+    return intern( key, Node {
+        .children  = { nw_id, ne_id, sw_id, se_id },
+        .level     = level,
+        .quiescent = m_nodes[nw_id].quiescent && m_nodes[ne_id].quiescent
+                  && m_nodes[sw_id].quiescent && m_nodes[se_id].quiescent
+    });
+}
+
+HashLife::NodeID HashLife::intern(const NodeKey& key, const Node& node) noexcept(false)
+{
+    const auto [entry, inserted] = m_table.try_emplace( key, static_cast<NodeID>( m_nodes.size() ) );
+
+    if ( inserted ) {
+        m_nodes.push_back(node);
+    }
+
+    return entry->second;
+}
+
+//===------------------------------------------------------------------------===
+// • Accessors
+//===------------------------------------------------------------------------===
+
+FieldValue HashLife::value(uint32_t x, uint32_t y) const noexcept
+{
+    assert( x < m_width && y < m_height );
+
+    auto id = m_field;
+
+    for ( auto level = m_level; 0 < level; --level )
+    {
+        const auto bit = 1u << (level - 1u);
+
+        id = child( id, ( (y & bit) ? 2u : 0u ) | ( (x & bit) ? 1u : 0u ) );
+    }
+
+    return unpack( m_nodes[id].children[0] );
+}
+
+//===------------------------------------------------------------------------===
+// • Transfer
+//===------------------------------------------------------------------------===
+
+void HashLife::load(const Grid& grid) noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    m_memo.clear();
+
+    m_field      = build(grid, 0, 0, m_level);
+    m_generation = 0;
+
+    if ( m_node_limit < m_nodes.size() ) {
+        collect();
+    }
+}
+
+void HashLife::store(Grid& grid) const noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    extract(m_field, 0, 0, grid);
+}
+
+HashLife::NodeID HashLife::build(const Grid& grid, uint32_t x, uint32_t y, uint32_t level) noexcept(false)
+{
+    if ( 0 == level ) {
+        return leaf( grid.at(x, y) );
+    }
+
+    // • A square field covers the shorter dimension with repeated tiles
+    //
+    const auto half = 1u << (level - 1u);
+
+    const auto nw_id = build(grid, x, y, level - 1u);
+    const auto ne_id = ( half < m_width )  ? build(grid, x + half, y, level - 1u) : nw_id;
+    const auto sw_id = ( half < m_height ) ? build(grid, x, y + half, level - 1u) : nw_id;
+    const auto se_id = ( half < m_width && half < m_height ) ? build(grid, x + half, y + half, level - 1u)
+                     : ( half < m_width )                    ? ne_id
+                     :                                          sw_id;
+
+    return node(nw_id, ne_id, sw_id, se_id);
+}
+
+void HashLife::extract(NodeID id, uint32_t x, uint32_t y, Grid& grid) const noexcept
+{
+    if ( m_width <= x || m_height <= y ) {
+        return;
+    }
+
+    const auto& current = m_nodes[id];
+
+    if ( 0 == current.level )
+    {
+        grid.at(x, y) = unpack( current.children[0] );
+        return;
+    }
+
+    const auto half = 1u << (current.level - 1u);
+
+    extract( current.children[nw], x,        y,        grid );
+    extract( current.children[ne], x + half, y,        grid );
+    extract( current.children[sw], x,        y + half, grid );
+    extract( current.children[se], x + half, y + half, grid );
+}
+
+//===------------------------------------------------------------------------===
+// • Successor
+//===------------------------------------------------------------------------===
+
+HashLife::NodeID HashLife::centre(NodeID id) noexcept(false)
+{
+    return node( child( child(id, nw), se ), child( child(id, ne), sw ),
+                 child( child(id, sw), ne ), child( child(id, se), nw ) );
+}
+
+HashLife::NodeID HashLife::successor(NodeID id, uint32_t j) noexcept(false)
+{
+    const auto level = m_nodes[id].level;
+
+    assert( 2u <= level && j + 2u <= level );
+
+    // • Nothing changes in a region with no live or stepping cells
+    //
+    if ( m_can_skip && m_nodes[id].quiescent ) {
+        return centre(id);
+    }
+
+    const auto key = ( uint64_t{ id } << 8 ) | j;
+
+    if ( const auto entry = m_memo.find(key); m_memo.end() != entry ) {
+        return entry->second;
+    }
+
+    if ( m_node_budget < m_nodes.size() || m_node_limit < m_memo.size() ) {
+        throw NodeBudgetSpent{};
+    }
+
+    auto result = NodeID{ invalid_id };
+
+    if ( 2u == level ) {
+        result = successor_base(id);
+    }
+    else
+    {
+        const auto nw_id = child(id, nw);
+        const auto ne_id = child(id, ne);
+        const auto sw_id = child(id, sw);
+        const auto se_id = child(id, se);
+
+        // • Nine overlapping sub-squares of half the size
+        //
+        NodeID sub[9] = {
+            nw_id,
+            node( child(nw_id, ne), child(ne_id, nw), child(nw_id, se), child(ne_id, sw) ),
+            ne_id,
+            node( child(nw_id, sw), child(nw_id, se), child(sw_id, nw), child(sw_id, ne) ),
+            node( child(nw_id, se), child(ne_id, sw), child(sw_id, ne), child(se_id, nw) ),
+            node( child(ne_id, sw), child(ne_id, se), child(se_id, nw), child(se_id, ne) ),
+            sw_id,
+            node( child(sw_id, ne), child(se_id, nw), child(sw_id, se), child(se_id, sw) ),
+            se_id
+        };
+
+        // • At full speed both halves of the jump are taken recursively,
+        //      otherwise the first half is a plain crop
+        //
+        const auto full = ( j + 2u == level );
+
+        for ( auto& square : sub ) {
+            square = full ? successor(square, j - 1u) : centre(square);
+        }
+
+        const auto next_j = full ? j - 1u : j;
+
+        const auto result_nw = successor( node(sub[0], sub[1], sub[3], sub[4]), next_j );
+        const auto result_ne = successor( node(sub[1], sub[2], sub[4], sub[5]), next_j );
+        const auto result_sw = successor( node(sub[3], sub[4], sub[6], sub[7]), next_j );
+        const auto result_se = successor( node(sub[4], sub[5], sub[7], sub[8]), next_j );
+
+        result = node(result_nw, result_ne, result_sw, result_se);
+    }
+
+    m_memo.emplace(key, result);
+
+    return result;
+}
+
+HashLife::NodeID HashLife::successor_base(NodeID id) noexcept(false)
+{
+    // • 4x4 cells to the center 2x2 after one generation
+    //
+    FieldValue cells[4][4];
+
+    for ( auto quadrant = 0u; quadrant < 4u; ++quadrant )
+    {
+        const auto quad = child(id, quadrant);
+
+        for ( auto index = 0u; index < 4u; ++index )
+        {
+            const auto x = (quadrant & 1u) * 2u + (index & 1u);
+            const auto y = (quadrant >> 1) * 2u + (index >> 1);
+
+            cells[y][x] = unpack( m_nodes[ child(quad, index) ].children[0] );
+        }
+    }
+
+    NodeID results[4];
+
+    for ( auto index = 0u; index < 4u; ++index )
+    {
+        const auto x = 1u + (index & 1u);
+        const auto y = 1u + (index >> 1);
+
+        auto neighbor_count = 0u;
+
+        for ( auto dy = 0u; dy < 3u; ++dy )
+        {
+            for ( auto dx = 0u; dx < 3u; ++dx )
+            {
+                if ( 1u != dx || 1u != dy ) {
+                    neighbor_count += cells[y + dy - 1u][x + dx - 1u].alive;
+                }
+            }
+        }
+
+        results[index] = leaf( step(cells[y][x], neighbor_count, m_rule) );
+    }
+
+    return node(results[0], results[1], results[2], results[3]);
+}
+
+//===------------------------------------------------------------------------===
+// • Advance
+//===------------------------------------------------------------------------===
+
+void HashLife::advance(uint64_t generations) noexcept(false)
+{
+    for ( auto j = uint32_t{ 0 }; 0 != generations; ++j, generations >>= 1 )
+    {
+        if ( 0 == (generations & 1u) ) {
+            continue;
+        }
+
+        try {
+            advance_pow2(j);
+        }
+        catch ( const NodeBudgetSpent& ) {
+            step_directly( uint64_t{ 1 } << j );
+        }
+
+        m_generation += uint64_t{ 1 } << j;
+
+        if ( m_node_limit < m_nodes.size() ) {
+            collect();
+        }
+    }
+}
+
+void HashLife::advance_pow2(uint32_t j) noexcept(false)
+{
+    // • The successor of a level k tiling is the tiling advanced 2^(k - 2)
+    //      generations and offset by 2^(k - 2) cells
+    //
+    const auto top = std::max(m_level + 1u, j + 2u);
+
+    auto tiling = m_field;
+
+    for ( auto level = m_level; level < top; ++level ) {
+        tiling = node(tiling, tiling, tiling, tiling);
+    }
+
+    // • The budget is what stepping directly would cost, and at most the
+    //      node limit
+    //
+    const auto cells = uint64_t{ m_width } * m_height;
+    const auto work  = ( j < static_cast<uint32_t>( std::countl_zero(cells) ) )
+                     ? ( cells << j ) / direct_cells_per_node
+                     : ~uint64_t{ 0 };
+
+    m_node_budget = std::min( m_node_limit, m_nodes.size() + std::min( work, uint64_t{ m_node_limit } ) );
+
+    auto result = successor(tiling, j);
+
+    if ( m_level + 1u == top )
+    {
+        // • Offset by half the field: swap the quadrants diagonally
+        //
+        m_field = node( child(result, se), child(result, sw), child(result, ne), child(result, nw) );
+    }
+    else
+    {
+        // • Offset by a whole number of fields
+        //
+        for ( auto level = top - 1u; m_level < level; --level ) {
+            result = child(result, nw);
+        }
+
+        m_field = result;
+    }
+}
+
+void HashLife::step_directly(uint64_t generations) noexcept(false)
+{
+    auto grid   = Grid{ m_width, m_height };
+    auto planes = BytePlanes{ m_width, m_height };
+
+    store(grid);
+    planes.load(grid);
+
+    for ( auto generation = uint64_t{ 0 }; generation < generations; ++generation ) {
+        planes.step(m_rule);
+    }
+
+    planes.store(grid);
+
+    m_field = build(grid, 0, 0, m_level);
+}
+
+//===------------------------------------------------------------------------===
+// • Collection
+//===------------------------------------------------------------------------===
+
+void HashLife::collect(void) noexcept(false)
+{
+    // • Re-intern the nodes reachable from the field into a fresh table
+    //
+    const auto previous = std::move(m_nodes);
+
+    m_nodes = {};
+    m_table.clear();
+    m_memo.clear();
+
+    auto remap = std::vector<NodeID>( previous.size(), invalid_id );
+
+    const auto copy = [&](const auto& self, NodeID id) -> NodeID
+    {
+        if ( invalid_id == remap[id] )
+        {
+            const auto& current = previous[id];
+
+            remap[id] = ( 0 == current.level )
+                      ? leaf( unpack( current.children[0] ) )
+                      : node( self(self, current.children[nw]), self(self, current.children[ne]),
+                              self(self, current.children[sw]), self(self, current.children[se]) );
+        }
+
+        return remap[id];
+    };
+
+    m_field = copy(copy, m_field);
+}
+
+} // namespace field
@@ -0,0 +1,175 @@
+//
+//  HashLife.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+#include <Shaders/Data/FieldValue.hpp>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+//
+// • HashLife
+//
+//  Memoized quadtree engine for jumping far ahead. Nodes are hash-consed, so
+//  identical regions share one node, and the leaves are whole FieldValues
+//  (alive, step and duration), so the timing of step_field is reproduced
+//  exactly. The successor of a level k node, its center advanced 2^j
+//  generations (j <= k - 2), is memoized per node and j.
+//
+//  The toroidal field is handled as the periodic tiling of the plane it is
+//  equivalent to, which requires power of two dimensions (not necessarily
+//  square). Advancing 2^j generations takes the successor of a tiling large
+//  enough to cover the light cone, and each set bit of the generation count
+//  is one such jump. The cost follows the number of distinct regions rather
+//  than the field area or the generation count, so repetitive or sparse
+//  fields advance in sub-linear time.
+//
+//  Chaotic fields are the opposite case: few regions recur, the memo rarely
+//  hits, and a jump creates a few nodes per cell and generation, each far
+//  dearer than stepping a cell. A jump is therefore abandoned once it has
+//  created one node per 4096 cells that stepping directly would visit, or
+//  once the table or the memo reaches the node limit, and its generations
+//  are stepped with BytePlanes instead.
+//
+//  Nodes are never freed while advancing; once the table grows past the
+//  node limit, unreachable nodes and the memo are discarded between jumps.
+//
+//===------------------------------------------------------------------------===
+
+class HashLife
+{
+public:
+
+    // • Constants
+    //
+    static constexpr size_t default_node_limit = size_t{ 1 } << 24;
+
+    // • Initialization (throws for Larger than Life and non-Moore rules,
+    //      bounded fields and stochastic rules)
+    //
+    HashLife(uint32_t width, uint32_t height, const AutomatRule& rule,
+             size_t node_limit = default_node_limit) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    constexpr uint64_t generation(void) const noexcept
+    {
+        return m_generation;
+    }
+
+    size_t node_count(void) const noexcept
+    {
+        return m_nodes.size();
+    }
+
+    FieldValue value(uint32_t x, uint32_t y) const noexcept;
+
+    // • Methods : transfer (load resets the generation count)
+    //
+    void load(const Grid& grid) noexcept(false);
+    void store(Grid& grid) const noexcept(false);
+
+    // • Methods : advance
+    //
+    void advance(uint64_t generations) noexcept(false);
+    void collect(void) noexcept(false);
+
+private:
+
+    // • Nodes (private)
+    //
+    using NodeID = uint32_t;
+
+    struct Node
+    {
+        NodeID      children[4];    // nw, ne, sw, se; a leaf holds its packed value in [0]
+        uint32_t    level;          // 2^level cells square
+        bool        quiescent;      // only dead cells that are not stepping
+    };
+
+    using NodeKey = std::array<uint32_t, 5>;
+
+    struct NodeKeyHash
+    {
+        size_t operator () (const NodeKey& key) const noexcept;
+    };
+
+    NodeID leaf(FieldValue value) noexcept(false);
+    NodeID node(NodeID nw, NodeID ne, NodeID sw, NodeID se) noexcept(false);
+    NodeID intern(const NodeKey& key, const Node& node) noexcept(false);
+
+    NodeID child(NodeID id, uint32_t quadrant) const noexcept
+    {
+        return m_nodes[id].children[quadrant];
+    }
+
+    // • Successor (private)
+    //
+    NodeID centre(NodeID id) noexcept(false);
+    NodeID successor(NodeID id, uint32_t j) noexcept(false);
+    NodeID successor_base(NodeID id) noexcept(false);
+    void   advance_pow2(uint32_t j) noexcept(false);
+    void   step_directly(uint64_t generations) noexcept(false);
+
+    // • Transfer (private)
+    //
+    NodeID build(const Grid& grid, uint32_t x, uint32_t y, uint32_t level) noexcept(false);
+    void   extract(NodeID id, uint32_t x, uint32_t y, Grid& grid) const noexcept;
+
+    // • Data members
+    //
+    uint32_t                                        m_width;
+    uint32_t                                        m_height;
+    uint32_t                                        m_level;        // field node level
+    AutomatRule                                     m_rule;
+    bool                                            m_can_skip;     // not born on zero neighbors
+    size_t                                          m_node_limit;
+    size_t                                          m_node_budget;  // node count ending the current jump
+
+    std::vector<Node>                               m_nodes;
+    std::unordered_map<NodeKey, NodeID, NodeKeyHash> m_table;
+    std::unordered_map<uint64_t, NodeID>            m_memo;         // (id << 8 | j) -> successor
+
+    NodeID                                          m_field;
+    uint64_t                                        m_generation;
+};
+
+} // namespace field
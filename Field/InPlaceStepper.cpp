@@ -0,0 +1,175 @@
+//
+//  InPlaceStepper.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/InPlaceStepper.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+InPlaceStepper::InPlaceStepper(uint32_t width, uint32_t height, uint32_t worker_count) noexcept(false)
+    :
+        m_width { width      },
+        m_height{ height     },
+        m_stride{ width + 2u },
+        m_pool  { worker_count }
+{
+    if ( 0 == width || 0 == height ) {
+        throw false;
+    }
+
+    // • One band per worker, at least one row each
+    //
+    const auto band_count = std::min( m_pool.worker_count(), height );
+
+    m_bands.resize(band_count + 1u);
+
+    for ( auto band = uint32_t{ 0 }; band <= band_count; ++band ) {
+        m_bands[band] = static_cast<uint32_t>( uint64_t{ height } * band / band_count );
+    }
+
+    m_windows.resize( m_pool.worker_count() );
+
+    for ( auto& window : m_windows )
+    {
+        for ( auto& row : window.rows ) {
+            row.resize(m_stride);
+        }
+    }
+
+    m_edges.resize( size_t{ band_count } * 2u * m_stride );
+}
+
+//===------------------------------------------------------------------------===
+// • Methods
+//===------------------------------------------------------------------------===
+
+void InPlaceStepper::step(Grid& grid, const AutomatRule& rule) noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    assert( !is_larger_than_life(rule) && is_moore(rule) && is_torus(rule) && !is_stochastic(rule) );
+
+    // • Edge rows of the previous generation, before any band overwrites them
+    //
+    const auto bands = band_count();
+
+    for ( auto band = uint32_t{ 0 }; band < bands; ++band )
+    {
+        load_row( grid.row(m_bands[band]),           edge_row(band, 0) + 1u );
+        load_row( grid.row(m_bands[band + 1u] - 1u), edge_row(band, 1) + 1u );
+    }
+
+    m_pool.run(bands, [&](uint32_t worker, uint32_t band) {
+        step_band(grid, band, m_windows[worker], rule);
+    });
+}
+
+//===------------------------------------------------------------------------===
+// • Private Methods
+//===------------------------------------------------------------------------===
+
+void InPlaceStepper::load_row(const FieldValue* row, uint8_t* alive) const noexcept
+{
+    for ( auto x = uint32_t{ 0 }; x < m_width; ++x ) {
+        alive[x] = row[x].alive;
+    }
+
+    alive[-1]      = alive[m_width - 1u];
+    alive[m_width] = alive[0];
+}
+
+void InPlaceStepper::step_band(Grid& grid, uint32_t band, Window& window, const AutomatRule& rule) noexcept
+{
+    const auto bands = band_count();
+    const auto begin = m_bands[band];
+    const auto end   = m_bands[band + 1u];
+
+    // • Window rows are filled in rotation, so the next row always replaces
+    //      the one that has just left the window
+    //
+    uint8_t* const buffers[3] = {
+        window.rows[0].data() + 1u, window.rows[1].data() + 1u, window.rows[2].data() + 1u
+    };
+
+    const uint8_t* upper  = edge_row( (band + bands - 1u) % bands, 1 ) + 1u;
+    const uint8_t* middle = buffers[0];
+    const uint8_t* lower  = edge_row( (band + 1u) % bands, 0 ) + 1u;
+
+    auto next = uint32_t{ 1 };
+
+    load_row( grid.row(begin), buffers[0] );
+
+    if ( begin + 1u < end )
+    {
+        lower = buffers[next];
+        load_row( grid.row(begin + 1u), buffers[next++] );
+    }
+
+    for ( auto y = begin; ; )
+    {
+        // • Windows from one column left of each cell
+        //
+        const auto* u   = upper  - 1;
+        const auto* m   = middle - 1;
+        const auto* l   = lower  - 1;
+        auto*       out = grid.row(y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            const auto neighbor_count = uint32_t{ u[x] } + u[x + 1] + u[x + 2]
+                                      + uint32_t{ m[x] }            + m[x + 2]
+                                      + uint32_t{ l[x] } + l[x + 1] + l[x + 2];
+
+            out[x] = field::step(out[x], neighbor_count, rule);
+        }
+
+        if ( end == ++y ) {
+            break;
+        }
+
+        upper  = middle;
+        middle = lower;
+
+        if ( y + 1u < end )
+        {
+            lower = buffers[next % 3u];
+            load_row( grid.row(y + 1u), buffers[next++ % 3u] );
+        }
+        else
+        {
+            lower = edge_row( (band + 1u) % bands, 0 ) + 1u;
+        }
+    }
+}
+
+} // namespace field
@@ -0,0 +1,117 @@
+//
+//  InPlaceStepper.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/WorkerPool.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+//
+// • InPlaceStepper
+//
+//  Steps a Grid in place rather than into a second field, so a field only
+//  needs to fit in memory once. The field is split into horizontal bands,
+//  one task each. A band steps its rows top to bottom keeping the previous
+//  generation's alive values of three rows in a rolling window: the row
+//  above, which has already been overwritten, the row being stepped and
+//  the row below, which is copied in before the row is overwritten.
+//
+//  The rows just outside a band belong to its neighbors, which overwrite
+//  them concurrently, so the first and last row of every band are copied
+//  before any band starts. Beyond the grid itself, a step uses three rows
+//  per worker and two per band. Results are identical to field::step.
+//
+//===------------------------------------------------------------------------===
+
+class InPlaceStepper
+{
+public:
+
+    // • Initialization (0 workers = one per hardware thread)
+    //
+    InPlaceStepper(uint32_t width, uint32_t height, uint32_t worker_count = 0) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    uint32_t band_count(void) const noexcept
+    {
+        return static_cast<uint32_t>( m_bands.size() - 1u );
+    }
+
+    uint32_t worker_count(void) const noexcept
+    {
+        return m_pool.worker_count();
+    }
+
+    // • Methods : step (Moore neighborhood, torus boundary and deterministic
+    //      rules only)
+    //
+    void step(Grid& grid, const AutomatRule& rule) noexcept(false);
+
+private:
+
+    // • Per-worker rolling window (private)
+    //
+    struct alignas(64) Window
+    {
+        std::vector<uint8_t>    rows[3];    // stride m_stride, ghost columns
+    };
+
+    uint8_t* edge_row(uint32_t band, uint32_t edge) noexcept
+    {
+        return m_edges.data() + ( size_t{ band } * 2u + edge ) * m_stride;
+    }
+
+    void load_row(const FieldValue* row, uint8_t* alive) const noexcept;
+    void step_band(Grid& grid, uint32_t band, Window& window, const AutomatRule& rule) noexcept;
+
+    // • Data members
+    //
+    uint32_t                m_width;
+    uint32_t                m_height;
+    uint32_t                m_stride;       // width plus two ghost columns
+    std::vector<uint32_t>   m_bands;        // first row of each band, then height
+
+    WorkerPool              m_pool;
+    std::vector<Window>     m_windows;
+    std::vector<uint8_t>    m_edges;        // first and last row of each band
+};
+
+} // namespace field
@@ -0,0 +1,370 @@
+//
+//  Keyframes.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/Keyframes.hpp>
+#include <Field/BytePlanes.hpp>
+#include <Field/Checkpoint.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+enum : uint32_t
+{
+    keyframe_magic   = 0x54586b66, // 'TXkf'
+    keyframe_version = 4
+};
+
+constexpr uint64_t padded_length(uint64_t length) noexcept
+{
+    return ( length + 7u ) & ~uint64_t{ 7 };
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Run-length snapshots
+//===------------------------------------------------------------------------===
+
+void encode_runs(const Grid& grid, std::vector<uint8_t>& buffer) noexcept(false)
+{
+    buffer.clear();
+
+    const auto* values = grid.data();
+    const auto  count  = grid.size();
+
+    for ( auto i = size_t{ 0 }; i < count; )
+    {
+        const auto value = values[i];
+        auto       end   = i + 1u;
+
+        while ( end < count && values[end] == value ) {
+            ++end;
+        }
+
+        for ( auto run = uint64_t{ end - i }; ; run >>= 7 )
+        {
+            if ( run < 0x80u )
+            {
+                buffer.push_back( static_cast<uint8_t>(run) );
+                break;
+            }
+
+            buffer.push_back( static_cast<uint8_t>( (run & 0x7fu) | 0x80u ) );
+        }
+
+        buffer.insert( buffer.end(), { value.alive, value.step, value.duration, value.reserved } );
+
+        i = end;
+    }
+}
+
+void decode_runs(const uint8_t* source, size_t length, Grid& grid) noexcept(false)
+{
+    const auto* end    = source + length;
+    auto*       values = grid.data();
+    const auto  count  = grid.size();
+    auto        i      = size_t{ 0 };
+
+    while ( source < end )
+    {
+        auto run   = uint64_t{ 0 };
+        auto shift = 0u;
+
+        for ( ; ; shift += 7u )
+        {
+            if ( end <= source || 63u < shift ) {
+                throw false;
+            }
+
+            const auto byte = *source++;
+            run |= uint64_t{ byte & 0x7fu } << shift;
+
+            if ( 0 == ( byte & 0x80u ) ) {
+                break;
+            }
+        }
+
+        if ( 0 == run || end - source < 4 || count - i < run ) {
+            throw false;
+        }
+
+        const auto value = FieldValue{ source[0], source[1], source[2], source[3] };
+        source += 4;
+
+        std::fill_n(values + i, run, value);
+        i += run;
+    }
+
+    if ( i != count ) {
+        throw false;
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • KeyframeWriter
+//===------------------------------------------------------------------------===
+
+KeyframeWriter::KeyframeWriter(std::filesystem::path path, uint32_t width, uint32_t height,
+                               const AutomatRule& rule, uint32_t interval) noexcept(false)
+    :
+        m_path      { std::move(path)        },
+        m_temp_path { temporary_path(m_path) },
+        m_descriptor{ -1                     },
+        m_header    {
+            .magic        = keyframe_magic,
+            .version      = keyframe_version,
+            .width        = width,
+            .height       = height,
+            .interval     = interval,
+            .rule         = rule,
+            .count        = 0,
+            .index_offset = 0
+        },
+        m_offset    { sizeof(KeyframeHeader) }
+{
+    // • Seeks step deterministically from a keyframe, which a stochastic
+    //      rule's draws would not match
+    //
+    if ( 0 == width || 0 == height || 0 == interval || is_stochastic(rule) ) {
+        throw false;
+    }
+
+    m_descriptor = ::open(m_temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if ( m_descriptor < 0 ) {
+        throw false;
+    }
+
+    // • Placeholder header until finish() knows where the index is
+    //
+    if ( !write_all(m_descriptor, &m_header, sizeof(m_header)) )
+    {
+        ::close(m_descriptor);
+        ::unlink(m_temp_path.c_str());
+        throw false;
+    }
+}
+
+KeyframeWriter::~KeyframeWriter(void) noexcept
+{
+    if ( 0 <= m_descriptor )
+    {
+        ::close(m_descriptor);
+        ::unlink(m_temp_path.c_str());
+    }
+}
+
+void KeyframeWriter::record(uint64_t generation, const Grid& grid) noexcept(false)
+{
+    if ( m_descriptor < 0 || !is_keyframe(generation)
+      || grid.width() != m_header.width || grid.height() != m_header.height
+      || ( !m_entries.empty() && generation <= m_entries.back().generation ) )
+    {
+        throw false;
+    }
+
+    encode_runs(grid, m_buffer);
+
+    const auto length = uint64_t{ m_buffer.size() };
+
+    m_entries.push_back( {
+        .generation = generation,
+        .offset     = m_offset,
+        .length     = length,
+        .checksum   = checksum(m_buffer.data(), m_buffer.size())
+    } );
+
+    m_buffer.resize( padded_length(length), 0 );
+
+    if ( !write_all(m_descriptor, m_buffer.data(), m_buffer.size()) ) {
+        throw false;
+    }
+
+    m_offset += m_buffer.size();
+}
+
+void KeyframeWriter::finish(void) noexcept(false)
+{
+    if ( m_descriptor < 0 ) {
+        throw false;
+    }
+
+    m_header.count        = m_entries.size();
+    m_header.index_offset = m_offset;
+
+    const auto index_length = m_entries.size() * sizeof(KeyframeEntry);
+
+    if ( !write_all(m_descriptor, m_entries.data(), index_length)
+      || static_cast<ssize_t>( sizeof(m_header) ) != ::pwrite(m_descriptor, &m_header, sizeof(m_header), 0) )
+    {
+        throw false;
+    }
+
+    const auto result = ::close(m_descriptor);
+    m_descriptor = -1;
+
+    if ( 0 != result || 0 != ::rename(m_temp_path.c_str(), m_path.c_str()) )
+    {
+        ::unlink(m_temp_path.c_str());
+        throw false;
+    }
+}
+
+void write_keyframes(const std::filesystem::path& path, const Grid& initial, const AutomatRule& rule,
+                     uint64_t generations, uint32_t interval) noexcept(false)
+{
+    auto writer = KeyframeWriter{ path, initial.width(), initial.height(), rule, interval };
+    auto planes = BytePlanes{ initial.width(), initial.height() };
+    auto grid   = initial;
+
+    planes.load(initial);
+    writer.record(0, initial);
+
+    for ( auto generation = uint64_t{ 1 }; generation <= generations; ++generation )
+    {
+        planes.step(rule);
+
+        if ( writer.is_keyframe(generation) )
+        {
+            planes.store(grid);
+            writer.record(generation, grid);
+        }
+    }
+
+    writer.finish();
+}
+
+//===------------------------------------------------------------------------===
+// • KeyframeIndex
+//===------------------------------------------------------------------------===
+
+KeyframeIndex::KeyframeIndex(const std::filesystem::path& path) noexcept(false)
+    :
+        m_file   { path    },
+        m_header {},
+        m_entries{ nullptr }
+{
+    const auto length = m_file.size();
+
+    if ( length < sizeof(KeyframeHeader) ) {
+        throw false;
+    }
+
+    std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+
+    // • The index must fit exactly between the last snapshot and the end
+    //
+    const auto valid = keyframe_magic   == m_header.magic
+                    && keyframe_version == m_header.version
+                    && 0 != m_header.width && 0 != m_header.height && 0 != m_header.interval
+                    && !is_stochastic(m_header.rule)
+                    && 0 != m_header.count
+                    && sizeof(KeyframeHeader) <= m_header.index_offset
+                    && 0 == m_header.index_offset % alignof(KeyframeEntry)
+                    && m_header.index_offset <= length
+                    && ( length - m_header.index_offset ) == m_header.count * sizeof(KeyframeEntry);
+
+    if ( !valid ) {
+        throw false;
+    }
+
+    m_entries = reinterpret_cast<const KeyframeEntry*>( m_file.data() + m_header.index_offset );
+}
+
+size_t KeyframeIndex::nearest(uint64_t generation) const noexcept(false)
+{
+    const auto* end = m_entries + m_header.count;
+
+    const auto* after = std::upper_bound(m_entries, end, generation,
+                                         [](uint64_t value, const KeyframeEntry& entry) noexcept {
+        return value < entry.generation;
+    });
+
+    if ( after == m_entries ) {
+        throw false;
+    }
+
+    return static_cast<size_t>( after - m_entries ) - 1u;
+}
+
+void KeyframeIndex::load(size_t index, Grid& grid) const noexcept(false)
+{
+    if ( m_header.count <= index || grid.width() != m_header.width || grid.height() != m_header.height ) {
+        throw false;
+    }
+
+    const auto& entry = m_entries[index];
+
+    if ( entry.offset < sizeof(KeyframeHeader) || m_header.index_offset < entry.offset
+      || m_header.index_offset - entry.offset < entry.length )
+    {
+        throw false;
+    }
+
+    const auto* snapshot = m_file.data() + entry.offset;
+
+    if ( checksum(snapshot, entry.length) != entry.checksum ) {
+        throw false;
+    }
+
+    decode_runs(snapshot, entry.length, grid);
+}
+
+void KeyframeIndex::seek(uint64_t generation, Grid& grid) const noexcept(false)
+{
+    const auto index = nearest(generation);
+
+    load(index, grid);
+
+    const auto remaining = generation - m_entries[index].generation;
+
+    if ( 0 < remaining )
+    {
+        auto planes = BytePlanes{ m_header.width, m_header.height };
+
+        planes.load(grid);
+
+        for ( auto i = uint64_t{ 0 }; i < remaining; ++i ) {
+            planes.step(m_header.rule);
+        }
+
+        planes.store(grid);
+    }
+}
+
+} // namespace field
@@ -0,0 +1,224 @@
+//
+//  Keyframes.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/MappedFile.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <type_traits>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Run-length snapshots
+//
+//  Each run of identical FieldValues is its length as a little-endian
+//  base-128 varint followed by the four value bytes. Settled regions of a
+//  field are long runs of one value, so a sparse field encodes to a few
+//  bytes per row. Decoding throws unless the runs exactly fill the grid.
+//===------------------------------------------------------------------------===
+
+void encode_runs(const Grid& grid, std::vector<uint8_t>& buffer) noexcept(false);
+void decode_runs(const uint8_t* source, size_t length, Grid& grid) noexcept(false);
+
+//===------------------------------------------------------------------------===
+// • Keyframe file layout
+//
+//  [KeyframeHeader] [snapshot]* [KeyframeEntry × count]
+//
+//  Snapshots are run-length encoded fields, each padded to eight bytes. The
+//  index of fixed-size entries sorted by generation follows the last
+//  snapshot, and the header at the start of the file locates it, so a
+//  reader maps the file and binary-searches the index in place.
+//===------------------------------------------------------------------------===
+
+struct KeyframeHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    interval;
+    AutomatRule rule;
+    uint64_t    count;
+    uint64_t    index_offset;
+};
+
+struct KeyframeEntry
+{
+    uint64_t    generation;
+    uint64_t    offset;
+    uint64_t    length;
+    uint64_t    checksum;
+};
+
+// • Both are written as laid out in memory, so no byte may be padding. The
+//      rule is 28 bytes, which leaves the counts aligned after it.
+//
+static_assert( 64 == sizeof(KeyframeHeader), "Unexpected size" );
+static_assert( 32 == sizeof(KeyframeEntry), "Unexpected size" );
+static_assert( std::has_unique_object_representations_v<KeyframeHeader>, "Unexpected padding" );
+static_assert( std::has_unique_object_representations_v<KeyframeEntry>, "Unexpected padding" );
+
+//===------------------------------------------------------------------------===
+//
+// • KeyframeWriter
+//
+//  Records a snapshot every interval generations while a field is being
+//  stepped. A smaller interval makes seeks step fewer generations at the
+//  cost of a larger file. The file is written under a temporary name and
+//  only appears at its path once finish() has written the index. Seeks step
+//  deterministically, so stochastic rules are rejected.
+//
+//===------------------------------------------------------------------------===
+
+class KeyframeWriter
+{
+public:
+
+    // • Initialization (throws for a stochastic rule)
+    //
+    KeyframeWriter(std::filesystem::path path, uint32_t width, uint32_t height,
+                   const AutomatRule& rule, uint32_t interval) noexcept(false);
+    ~KeyframeWriter(void) noexcept;
+
+    KeyframeWriter(const KeyframeWriter& ) = delete;
+    KeyframeWriter& operator = (const KeyframeWriter& ) = delete;
+
+    // • Accessors
+    //
+    constexpr uint32_t interval(void) const noexcept
+    {
+        return m_header.interval;
+    }
+
+    constexpr bool is_keyframe(uint64_t generation) const noexcept
+    {
+        return 0 == generation % m_header.interval;
+    }
+
+    size_t keyframe_count(void) const noexcept
+    {
+        return m_entries.size();
+    }
+
+    // • Methods (generations must be keyframes, in increasing order)
+    //
+    void record(uint64_t generation, const Grid& grid) noexcept(false);
+    void finish(void) noexcept(false);
+
+private:
+
+    // • Data members
+    //
+    std::filesystem::path       m_path;
+    std::filesystem::path       m_temp_path;
+    int                         m_descriptor;
+    KeyframeHeader              m_header;
+    uint64_t                    m_offset;
+    std::vector<KeyframeEntry>  m_entries;
+    std::vector<uint8_t>        m_buffer;
+};
+
+// • Steps the field from generation 0 and records every keyframe up to and
+//      including the last generation
+//
+void write_keyframes(const std::filesystem::path& path, const Grid& initial, const AutomatRule& rule,
+                     uint64_t generations, uint32_t interval) noexcept(false);
+
+//===------------------------------------------------------------------------===
+//
+// • KeyframeIndex
+//
+//  Read-only mapping of a keyframe file. seek() decodes the nearest keyframe
+//  at or before the requested generation and steps forward from it, so it
+//  costs one decode and fewer than interval steps wherever it lands.
+//
+//===------------------------------------------------------------------------===
+
+class KeyframeIndex
+{
+public:
+
+    // • Initialization (throws when missing, malformed or stochastic)
+    //
+    explicit KeyframeIndex(const std::filesystem::path& path) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_header.width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_header.height;
+    }
+
+    constexpr const AutomatRule& rule(void) const noexcept
+    {
+        return m_header.rule;
+    }
+
+    constexpr uint32_t interval(void) const noexcept
+    {
+        return m_header.interval;
+    }
+
+    constexpr size_t keyframe_count(void) const noexcept
+    {
+        return m_header.count;
+    }
+
+    uint64_t generation(size_t index) const noexcept
+    {
+        return m_entries[index].generation;
+    }
+
+    // • Index of the last keyframe at or before the generation
+    //
+    size_t nearest(uint64_t generation) const noexcept(false);
+
+    // • Methods (throw on a corrupt snapshot)
+    //
+    void load(size_t index, Grid& grid) const noexcept(false);
+    void seek(uint64_t generation, Grid& grid) const noexcept(false);
+
+private:
+
+    // • Data members
+    //
+    MappedFile              m_file;
+    KeyframeHeader          m_header;
+    const KeyframeEntry*    m_entries;
+};
+
+} // namespace field
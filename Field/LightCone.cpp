@@ -0,0 +1,112 @@
+//
+//  LightCone.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/LightCone.hpp>
+
+#include <cassert>
+#include <utility>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+// • One axis of an expanded region: first cell (wrapped) and cell count,
+//      or the whole axis once the expansion reaches around the torus
+//
+std::pair<uint32_t, uint32_t> expand_axis(uint32_t begin, uint32_t end, uint32_t margin, uint32_t size) noexcept
+{
+    const auto count = uint64_t{ end - begin } + 2u * uint64_t{ margin };
+
+    if ( size <= count ) {
+        return { 0u, size };
+    }
+
+    const auto first = ( int64_t{ begin } - margin ) % int64_t{ size } + size;
+
+    return { static_cast<uint32_t>( first % size ), static_cast<uint32_t>(count) };
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • TorusRegion
+//===------------------------------------------------------------------------===
+
+TorusRegion make_torus_region(const FieldRegion& region, uint32_t margin,
+                              uint32_t field_width, uint32_t field_height) noexcept
+{
+    const auto [left, width]  = expand_axis(region.left, region.right,  margin, field_width);
+    const auto [top,  height] = expand_axis(region.top,  region.bottom, margin, field_height);
+
+    return { left, top, width, height };
+}
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+LightCone::LightCone(uint32_t field_width, uint32_t field_height,
+                     const FieldRegion& visible, uint32_t generations) noexcept(false)
+    :
+        m_field_width { field_width  },
+        m_field_height{ field_height },
+        m_visible     { visible      },
+        m_remaining   { generations  }
+{
+    if ( visible.right <= visible.left || visible.bottom <= visible.top
+      || field_width < visible.right || field_height < visible.bottom )
+    {
+        throw false;
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Accessors
+//===------------------------------------------------------------------------===
+
+TorusRegion LightCone::region(void) const noexcept
+{
+    assert( !is_complete() );
+
+    return make_torus_region(m_visible, m_remaining - 1u, m_field_width, m_field_height);
+}
+
+size_t LightCone::remaining_cell_count(void) const noexcept
+{
+    auto count = size_t{ 0 };
+
+    for ( auto margin = uint32_t{ 0 }; margin < m_remaining; ++margin )
+    {
+        count += cell_count( make_torus_region(m_visible, margin, m_field_width, m_field_height) );
+    }
+
+    return count;
+}
+
+} // namespace field
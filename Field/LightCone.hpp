@@ -0,0 +1,133 @@
+//
+//  LightCone.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • TorusRegion
+//
+//  Rectangle of a toroidal field that may wrap across its edges: the cells
+//  (left + i) mod width, (top + j) mod height. A region as wide or as tall
+//  as the field covers that whole axis.
+//===------------------------------------------------------------------------===
+
+struct TorusRegion
+{
+    uint32_t    left;
+    uint32_t    top;
+    uint32_t    width;
+    uint32_t    height;
+};
+
+constexpr size_t cell_count(const TorusRegion& region) noexcept
+{
+    return size_t{ region.width } * region.height;
+}
+
+// • Region expanded by margin cells on every side, wrapped to the field and
+//      clipped to its size
+//
+TorusRegion make_torus_region(const FieldRegion& region, uint32_t margin,
+                              uint32_t field_width, uint32_t field_height) noexcept;
+
+//===------------------------------------------------------------------------===
+//
+// • LightCone
+//
+//  Backward light cone of a visible region over a finite number of
+//  generations. A cell can only influence its neighbors, so for the visible
+//  region to be correct after the last generation, the step producing a
+//  generation with n generations still to follow only has to compute the
+//  visible region expanded by n cells. The cone shrinks by one cell on each
+//  side per step, down to the visible region itself; cells outside it are
+//  left stale.
+//
+//===------------------------------------------------------------------------===
+
+class LightCone
+{
+public:
+
+    // • Initialization
+    //
+    LightCone(uint32_t field_width, uint32_t field_height,
+              const FieldRegion& visible, uint32_t generations) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr uint32_t remaining(void) const noexcept
+    {
+        return m_remaining;
+    }
+
+    constexpr bool is_complete(void) const noexcept
+    {
+        return 0 == m_remaining;
+    }
+
+    constexpr const FieldRegion& visible(void) const noexcept
+    {
+        return m_visible;
+    }
+
+    // • Region the next step has to compute (requires !is_complete())
+    //
+    TorusRegion region(void) const noexcept;
+
+    // • Cells computed by the remaining steps, and by stepping the whole field
+    //
+    size_t remaining_cell_count(void) const noexcept;
+
+    size_t field_cell_count(void) const noexcept
+    {
+        return size_t{ m_field_width } * m_field_height * m_remaining;
+    }
+
+    // • Methods
+    //
+    void advance(void) noexcept
+    {
+        if ( 0 < m_remaining ) {
+            --m_remaining;
+        }
+    }
+
+private:
+
+    // • Data members
+    //
+    uint32_t            m_field_width;
+    uint32_t            m_field_height;
+    FieldRegion         m_visible;
+    uint32_t            m_remaining;
+};
+
+} // namespace field
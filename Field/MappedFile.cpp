@@ -0,0 +1,150 @@
+//
+//  MappedFile.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/MappedFile.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • MappedFile
+//===------------------------------------------------------------------------===
+
+MappedFile::MappedFile(const std::filesystem::path& path) noexcept(false)
+    :
+        m_mapping{ nullptr },
+        m_length { 0 }
+{
+    const auto descriptor = ::open(path.c_str(), O_RDONLY);
+
+    if ( descriptor < 0 ) {
+        throw false;
+    }
+
+    struct stat status;
+
+    if ( 0 != ::fstat(descriptor, &status) || 0 == status.st_size )
+    {
+        ::close(descriptor);
+        throw false;
+    }
+
+    const auto length  = static_cast<size_t>(status.st_size);
+    const auto mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    ::close(descriptor);
+
+    if ( MAP_FAILED == mapping ) {
+        throw false;
+    }
+
+    m_mapping = mapping;
+    m_length  = length;
+}
+
+MappedFile::~MappedFile(void) noexcept
+{
+    if ( nullptr != m_mapping ) {
+        ::munmap(m_mapping, m_length);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    :
+        m_mapping{ std::exchange(other.m_mapping, nullptr) },
+        m_length { std::exchange(other.m_length, 0)        }
+{
+}
+
+MappedFile& MappedFile::operator = (MappedFile&& other) noexcept
+{
+    if ( this != &other )
+    {
+        if ( nullptr != m_mapping ) {
+            ::munmap(m_mapping, m_length);
+        }
+
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_length  = std::exchange(other.m_length, 0);
+    }
+
+    return *this;
+}
+
+//===------------------------------------------------------------------------===
+// • Writing
+//===------------------------------------------------------------------------===
+
+bool write_all(int descriptor, const void* bytes, size_t length) noexcept
+{
+    const auto* source = static_cast<const uint8_t*>(bytes);
+
+    while ( 0 < length )
+    {
+        const auto written = ::write(descriptor, source, length);
+
+        if ( written < 0 )
+        {
+            // • A signal before anything was written is not a failure
+            //
+            if ( EINTR == errno ) {
+                continue;
+            }
+
+            return false;
+        }
+
+        source += written;
+        length -= static_cast<size_t>(written);
+    }
+
+    return true;
+}
+
+std::filesystem::path temporary_path(const std::filesystem::path& path) noexcept(false)
+{
+    // • Stores may run at once on several threads, such as Metal completion
+    //      handlers, so each call takes its own name within the process
+    //
+    static auto counter = std::atomic<uint64_t>{ 0 };
+
+    const auto serial = counter.fetch_add(1, std::memory_order_relaxed);
+
+    auto temp_path = path;
+
+    temp_path += ".tmp." + std::to_string( ::getpid() ) + "." + std::to_string(serial);
+
+    return temp_path;
+}
+
+} // namespace field
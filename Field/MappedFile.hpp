@@ -0,0 +1,89 @@
+//
+//  MappedFile.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+//
+// • MappedFile
+//
+//  Read-only, private mapping of a whole file
+//
+//===------------------------------------------------------------------------===
+
+class MappedFile
+{
+public:
+
+    // • Initialization (throws when the file cannot be opened or mapped)
+    //
+    explicit MappedFile(const std::filesystem::path& path) noexcept(false);
+    ~MappedFile(void) noexcept;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator = (MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile& ) = delete;
+    MappedFile& operator = (const MappedFile& ) = delete;
+
+    // • Accessors
+    //
+    const uint8_t* data(void) const noexcept
+    {
+        return static_cast<const uint8_t*>(m_mapping);
+    }
+
+    size_t size(void) const noexcept
+    {
+        return m_length;
+    }
+
+private:
+
+    // • Data members
+    //
+    void*   m_mapping;
+    size_t  m_length;
+};
+
+//===------------------------------------------------------------------------===
+// • Writing
+//===------------------------------------------------------------------------===
+
+// • Writes every byte, retrying short writes
+//
+bool write_all(int descriptor, const void* bytes, size_t length) noexcept;
+
+// • Temporary path beside the destination, unique to this call within the
+//      process, for writing a file that is renamed into place once complete
+//
+std::filesystem::path temporary_path(const std::filesystem::path& path) noexcept(false);
+
+} // namespace field
@@ -0,0 +1,172 @@
+//
+//  RuleFile.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/RuleFile.hpp>
+
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+//===------------------------------------------------------------------------===
+// • File layout
+//
+//  [RuleFileHeader] [RankedRule × count], best first. Both are written as
+//  they are laid out in memory, so the version changes whenever either
+//  structure does.
+//===------------------------------------------------------------------------===
+
+enum : uint32_t
+{
+    rule_file_magic   = 0x54587273, // 'TXrs'
+    rule_file_version = 4
+};
+
+struct RuleFileHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    count;
+    uint32_t    initial_step_count;
+    FieldSeed   seed;
+};
+
+static_assert( std::is_trivially_copyable_v<RankedRule>, "Unexpected type" );
+static_assert( 0 == sizeof(RuleFileHeader) % alignof(RankedRule), "Unexpected alignment" );
+
+const RuleFileHeader& header(const MappedFile& file) noexcept
+{
+    return *reinterpret_cast<const RuleFileHeader*>( file.data() );
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+RuleFile::RuleFile(const std::filesystem::path& path) noexcept(false)
+    :
+        m_file { path    },
+        m_rules{ nullptr },
+        m_count{ 0       }
+{
+    if ( m_file.size() < sizeof(RuleFileHeader) ) {
+        throw false;
+    }
+
+    const auto& file_header = header(m_file);
+
+    if ( rule_file_magic != file_header.magic || rule_file_version != file_header.version ) {
+        throw false;
+    }
+
+    if ( m_file.size() != sizeof(RuleFileHeader) + size_t{ file_header.count } * sizeof(RankedRule) ) {
+        throw false;
+    }
+
+    m_rules = reinterpret_cast<const RankedRule*>( m_file.data() + sizeof(RuleFileHeader) );
+    m_count = file_header.count;
+}
+
+//===------------------------------------------------------------------------===
+// • Accessors
+//===------------------------------------------------------------------------===
+
+const FieldSeed& RuleFile::seed(void) const noexcept
+{
+    return header(m_file).seed;
+}
+
+uint32_t RuleFile::initial_step_count(void) const noexcept
+{
+    return header(m_file).initial_step_count;
+}
+
+//===------------------------------------------------------------------------===
+// • Writing
+//===------------------------------------------------------------------------===
+
+bool write_rule_file(const std::filesystem::path& path, const FieldSeed& seed,
+                     uint32_t initial_step_count, const RankedRule* rules, size_t count) noexcept
+{
+    if ( UINT32_MAX < count ) {
+        return false;
+    }
+
+    try
+    {
+        const auto temp_path = temporary_path(path);
+
+        const auto file_header = RuleFileHeader {
+            .magic              = rule_file_magic,
+            .version            = rule_file_version,
+            .count              = static_cast<uint32_t>(count),
+            .initial_step_count = initial_step_count,
+            .seed               = seed
+        };
+
+        const auto descriptor = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if ( descriptor < 0 ) {
+            return false;
+        }
+
+        const auto written = write_all(descriptor, &file_header, sizeof(file_header))
+                          && write_all(descriptor, rules, count * sizeof(RankedRule));
+
+        auto error = std::error_code{};
+
+        if ( 0 != ::close(descriptor) || !written )
+        {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        std::filesystem::rename(temp_path, path, error);
+
+        if ( error )
+        {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        return true;
+    }
+    catch ( ... )
+    {
+        return false;
+    }
+}
+
+} // namespace field
@@ -0,0 +1,84 @@
+//
+//  RuleFile.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/MappedFile.hpp>
+#include <Field/RuleSearch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+//
+// • RuleFile
+//
+//  Ranked search results with the field seed and warm-up step count they
+//  were found with, everything a composition needs besides its
+//  colorization. Written to a temporary file and renamed into place like a
+//  checkpoint; read through a mapping that is validated before use.
+//
+//===------------------------------------------------------------------------===
+
+class RuleFile
+{
+public:
+
+    // • Initialization (throws when missing, of another version or truncated)
+    //
+    explicit RuleFile(const std::filesystem::path& path) noexcept(false);
+
+    // • Accessors
+    //
+    const FieldSeed&    seed(void) const noexcept;
+    uint32_t            initial_step_count(void) const noexcept;
+
+    size_t size(void) const noexcept
+    {
+        return m_count;
+    }
+
+    const RankedRule& operator [] (size_t rank) const noexcept
+    {
+        return m_rules[rank];
+    }
+
+private:
+
+    // • Data members
+    //
+    MappedFile          m_file;
+    const RankedRule*   m_rules;
+    size_t              m_count;
+};
+
+// • Writes count ranked rules, best first
+//
+bool write_rule_file(const std::filesystem::path& path, const FieldSeed& seed,
+                     uint32_t initial_step_count, const RankedRule* rules, size_t count) noexcept;
+
+} // namespace field
@@ -0,0 +1,102 @@
+//
+//  RuleKernel.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/RuleKernel.hpp>
+#include <Field/Step.hpp>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+struct RuleKernelEntry
+{
+    AutomatRule     rule;
+    StepRowKernel   kernel;
+};
+
+template <typename Kernel_>
+constexpr RuleKernelEntry make_entry(void) noexcept
+{
+    return { Kernel_::rule, Kernel_::step_row };
+}
+
+constexpr RuleKernelEntry common_rules[] =
+{
+    make_entry< RuleKernel<0b000011000, 0b000011100, 0, 19> >(),    // Composition.mm
+    make_entry< RuleKernel<0b000001000, 0b000001100, 0,  0> >(),    // Life, B3/S23
+    make_entry< RuleKernel<0b001001000, 0b000001100, 0,  0> >(),    // HighLife, B36/S23
+    make_entry< RuleKernel<0b111001000, 0b111011000, 0,  0> >(),    // Day & Night, B3678/S34678
+    make_entry< RuleKernel<0b000000100, 0b000000000, 0,  0> >(),    // Seeds, B2/S
+    make_entry< RuleKernel<0b000000100, 0b000000000, 0,  1> >(),    // Brian's Brain, B2/S/3
+};
+
+constexpr bool operator == (const AutomatRule& lhs, const AutomatRule& rhs) noexcept
+{
+    return lhs.born             == rhs.born
+        && lhs.survive          == rhs.survive
+        && lhs.growth_duration  == rhs.growth_duration
+        && lhs.decline_duration == rhs.decline_duration;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Lookup
+//===------------------------------------------------------------------------===
+
+StepRowKernel rule_kernel(const AutomatRule& rule) noexcept
+{
+    if ( is_larger_than_life(rule) || !is_moore(rule) ) {
+        return nullptr;
+    }
+
+    for ( const auto& entry : common_rules )
+    {
+        if ( entry.rule == rule ) {
+            return entry.kernel;
+        }
+    }
+
+    return nullptr;
+}
+
+StepRowKernel step_row_kernel(const AutomatRule& rule, bool odd_row, bool counted) noexcept
+{
+    if ( StepKernelISA::scalar != best_step_kernel_isa() || !is_moore(rule) || counted ) {
+        return step_row_kernel( best_step_kernel_isa(), rule.topology, odd_row, counted );
+    }
+
+    if ( const auto kernel = rule_kernel(rule) ) {
+        return kernel;
+    }
+
+    return step_row_scalar;
+}
+
+} // namespace field
@@ -0,0 +1,165 @@
+//
+//  RuleKernel.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/StepKernel.hpp>
+
+#include <array>
+#include <bit>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Neighborhood table
+//
+//  Next alive value of a settled cell for each 3x3 neighborhood, indexed by
+//  nine bits: three per column from west to east, each column holding the
+//  upper, middle and lower cells from its low bit. Bit 4 is the cell itself.
+//===------------------------------------------------------------------------===
+
+using NeighborhoodTable = std::array<uint8_t, 512>;
+
+constexpr NeighborhoodTable make_neighborhood_table(uint16_t born, uint16_t survive) noexcept
+{
+    auto table = NeighborhoodTable{};
+
+    for ( auto index = 0u; index < 512u; ++index )
+    {
+        const auto alive          = 0 != ( index & 0x10u );
+        const auto neighbor_count = static_cast<uint32_t>( std::popcount(index & ~0x10u) );
+        const auto mask           = alive ? survive : born;
+
+        table[index] = ( 0 != ( mask & (1u << neighbor_count) ) ) ? 1 : 0;
+    }
+
+    return table;
+}
+
+//===------------------------------------------------------------------------===
+//
+// • RuleKernel
+//
+//  Row kernel specialized for one rule: the born and survive masks become a
+//  compile-time neighborhood table walked with a rolling index, and the
+//  transitions a rule cannot make are compiled out. A rule with no births
+//  has no growth path, one that survives on every count has no decline
+//  path, and a zero duration reduces a transition to writing zero. The
+//  AutomatRule argument is ignored, so the kernel is only valid for the
+//  rule it was instantiated with.
+//
+//===------------------------------------------------------------------------===
+
+template <uint16_t Born_, uint16_t Survive_, uint8_t GrowthDuration_, uint8_t DeclineDuration_>
+class RuleKernel
+{
+public:
+
+    // • Constants
+    //
+    static constexpr auto rule  = AutomatRule {
+        .born             = Born_,
+        .survive          = Survive_,
+        .growth_duration  = GrowthDuration_,
+        .decline_duration = DeclineDuration_,
+        .radius           = 1
+    };
+    static constexpr auto table = make_neighborhood_table(Born_, Survive_);
+
+    static constexpr bool has_growth  = 0 != ( Born_ & 0x1ff );
+    static constexpr bool has_decline = 0x1ff != ( Survive_ & 0x1ff );
+
+    // • Methods
+    //
+    static void step_row(const StepRow& row, uint32_t width, const AutomatRule& ) noexcept
+    {
+        if ( 0 == width ) {
+            return;
+        }
+
+        const auto column = [&row](int64_t x) noexcept -> uint32_t
+        {
+            return uint32_t{ row.upper[x] } | ( uint32_t{ row.middle[x] } << 1 ) | ( uint32_t{ row.lower[x] } << 2 );
+        };
+
+        auto index = ( column(-1) << 3 ) | ( column(0) << 6 );
+
+        for ( auto x = uint32_t{ 0 }; x < width; ++x )
+        {
+            index = ( index >> 3 ) | ( column(x + 1) << 6 );
+
+            const auto alive    = row.middle[x];
+            const auto step     = row.step[x];
+            const auto duration = row.duration[x];
+            const auto settled  = ( 0 == step );
+            const auto next     = settled ? table[index] : alive;
+
+            auto next_step     = static_cast<uint8_t>( step - !settled );
+            auto next_duration = duration;
+
+            if constexpr ( has_growth )
+            {
+                if ( next & ~alive )
+                {
+                    next_step     = GrowthDuration_;
+                    next_duration = GrowthDuration_;
+                }
+            }
+
+            if constexpr ( has_decline )
+            {
+                if ( alive & ~next )
+                {
+                    next_step     = DeclineDuration_;
+                    next_duration = DeclineDuration_;
+                }
+            }
+
+            row.next_alive[x]    = next;
+            row.next_step[x]     = next_step;
+            row.next_duration[x] = next_duration;
+        }
+    }
+};
+
+//===------------------------------------------------------------------------===
+// • Common rules
+//
+//  Specialized kernels for the rules that are rendered repeatedly, looked up
+//  by value at run time
+//===------------------------------------------------------------------------===
+
+// • Specialized kernel for the rule, or nullptr when there is none (Moore
+//      neighborhood only)
+//
+StepRowKernel rule_kernel(const AutomatRule& rule) noexcept;
+
+// • Fastest kernel for the rule's rows of the given parity: the widest
+//      vector kernel the processor supports, a specialized kernel where there
+//      is no vector kernel, or the generic scalar kernel. Specialized kernels
+//      do not count, so a counted kernel is never one.
+//
+StepRowKernel step_row_kernel(const AutomatRule& rule, bool odd_row = false, bool counted = false) noexcept;
+
+} // namespace field
@@ -0,0 +1,324 @@
+//
+//  RuleSearch.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/RuleSearch.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+constexpr uint32_t moore_born_masks    = 1u << 8;   // born on 1...8
+constexpr uint32_t moore_survive_masks = 1u << 9;   // survive on 0...8
+
+// • Shortest period with which a sequence of (population, transitions)
+//      pairs repeats from start to end, or 0
+//
+uint32_t shortest_period(const std::vector<uint64_t>& history) noexcept
+{
+    const auto length = static_cast<uint32_t>( history.size() / 2u );
+
+    for ( auto period = uint32_t{ 1 }; 2u * period <= length; ++period )
+    {
+        const auto repeats = std::equal( history.begin() + 2u * period, history.end(), history.begin() );
+
+        if ( repeats ) {
+            return period;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Seeding
+//===------------------------------------------------------------------------===
+
+void seed_field(const FieldSeed& seed, Grid& grid) noexcept(false)
+{
+    if ( grid.width() != seed.field_width || grid.height() != seed.field_height ) {
+        throw false;
+    }
+
+    std::fill( grid.data(), grid.data() + grid.size(), FieldValue{ 0, 0, 0, 0 } );
+
+    for ( auto instance = uint32_t{ 0 }; instance < seed.count; ++instance )
+    {
+        // • Instances are offset in the same unsigned arithmetic as the vertex
+        //      shader, so one that wraps is off the field there too
+        //
+        const auto dx     = static_cast<uint32_t>(seed.offset_x) * instance;
+        const auto dy     = static_cast<uint32_t>(seed.offset_y) * instance;
+        const auto left   = seed.base_region.left + dx;
+        const auto top    = seed.base_region.top  + dy;
+        const auto right  = std::min( seed.base_region.right  + dx, grid.width() );
+        const auto bottom = std::min( seed.base_region.bottom + dy, grid.height() );
+
+        for ( auto y = top; y < bottom; ++y )
+        {
+            auto* row = grid.row(y);
+
+            for ( auto x = left; x < right; ++x ) {
+                row[x].alive = 1;
+            }
+        }
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Rule space
+//===------------------------------------------------------------------------===
+
+std::vector<AutomatRule> enumerate_rules(const AutomatRule& base) noexcept(false)
+{
+    auto rules = std::vector<AutomatRule>{};
+
+    rules.reserve( size_t{ moore_born_masks } * moore_survive_masks );
+
+    for ( auto born = uint32_t{ 0 }; born < moore_born_masks; ++born )
+    {
+        for ( auto survive = uint32_t{ 0 }; survive < moore_survive_masks; ++survive )
+        {
+            auto rule = base;
+
+            rule.born    = static_cast<uint16_t>( born << 1 );
+            rule.survive = static_cast<uint16_t>( survive );
+            rule.radius  = 1;
+
+            rules.push_back(rule);
+        }
+    }
+
+    return rules;
+}
+
+std::vector<AutomatRule> sample_rules(const AutomatRule& base, uint32_t count, uint64_t seed) noexcept(false)
+{
+    auto generator = std::mt19937_64{ seed };
+    auto born      = std::uniform_int_distribution<uint32_t>{ 0, moore_born_masks - 1u };
+    auto survive   = std::uniform_int_distribution<uint32_t>{ 0, moore_survive_masks - 1u };
+    auto growth    = std::uniform_int_distribution<uint32_t>{ 0, base.growth_duration };
+    auto decline   = std::uniform_int_distribution<uint32_t>{ 0, base.decline_duration };
+
+    auto rules = std::vector<AutomatRule>{};
+
+    rules.reserve(count);
+
+    for ( auto index = uint32_t{ 0 }; index < count; ++index )
+    {
+        auto rule = base;
+
+        rule.born             = static_cast<uint16_t>( born(generator) << 1 );
+        rule.survive          = static_cast<uint16_t>( survive(generator) );
+        rule.growth_duration  = static_cast<uint8_t>( growth(generator) );
+        rule.decline_duration = static_cast<uint8_t>( decline(generator) );
+        rule.radius           = 1;
+
+        rules.push_back(rule);
+    }
+
+    return rules;
+}
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+RuleSearch::RuleSearch(const FieldSeed& seed, const RuleSearchOptions& options,
+                       uint32_t worker_count) noexcept(false)
+    :
+        m_field_seed{ seed    },
+        m_options   { options },
+        m_seed      { seed.field_width, seed.field_height },
+        m_stepper   { seed.field_width, seed.field_height, worker_count }
+{
+    if ( 0 == options.generation_count || 0 == options.prune_interval ) {
+        throw false;
+    }
+
+    seed_field(seed, m_seed);
+}
+
+//===------------------------------------------------------------------------===
+// • Methods
+//===------------------------------------------------------------------------===
+
+std::vector<RankedRule> RuleSearch::run(const std::vector<AutomatRule>& rules) noexcept(false)
+{
+    for ( const auto& rule : rules )
+    {
+        if ( is_larger_than_life(rule) || !is_moore(rule) || !is_torus(rule) || is_stochastic(rule) ) {
+            throw false;
+        }
+    }
+
+    auto results = std::vector<RankedRule>( rules.size() );
+
+    for ( auto first = size_t{ 0 }; first < rules.size(); first += BatchStepper::lane_count )
+    {
+        const auto count = std::min( rules.size() - first, size_t{ BatchStepper::lane_count } );
+
+        run_batch( rules.data() + first, static_cast<uint32_t>(count), results.data() + first );
+    }
+
+    std::stable_sort( results.begin(), results.end(), [](const RankedRule& lhs, const RankedRule& rhs) {
+        return lhs.score > rhs.score;
+    });
+
+    return results;
+}
+
+//===------------------------------------------------------------------------===
+// • Private Methods
+//===------------------------------------------------------------------------===
+
+void RuleSearch::run_batch(const AutomatRule* rules, uint32_t count, RankedRule* results) noexcept(false)
+{
+    const auto area        = double( m_seed.width() ) * m_seed.height();
+    const auto generations = m_options.generation_count;
+    const auto window      = std::min(m_options.cycle_window, generations);
+
+    m_stepper.clear();
+
+    auto candidates = std::vector<Candidate>(count);
+
+    for ( auto lane = uint32_t{ 0 }; lane < count; ++lane )
+    {
+        m_stepper.add(rules[lane], m_seed);
+        candidates[lane].history.reserve( 2u * window );
+    }
+
+    auto active = count;
+
+    for ( auto generation = uint32_t{ 1 }; generation <= generations && 0 < active; ++generation )
+    {
+        m_stepper.step();
+
+        for ( auto lane = uint32_t{ 0 }; lane < count; ++lane )
+        {
+            auto& candidate = candidates[lane];
+
+            if ( rule_outcome_survived != candidate.outcome ) {
+                continue;
+            }
+
+            const auto& stats       = m_stepper.stats(lane);
+            const auto  transitions = stats.growth + stats.decline;
+
+            candidate.generation_count = generation;
+
+            if ( m_options.warmup_count < generation )
+            {
+                const auto population = double( stats.population ) / area;
+
+                candidate.population_sum     += population;
+                candidate.population_squares += population * population;
+                candidate.transition_sum     += double( transitions ) / area;
+                candidate.sample_count       += 1u;
+            }
+
+            if ( generations - window < generation ) {
+                candidate.history.insert( candidate.history.end(), { stats.population, transitions } );
+            }
+
+            // • Pruning
+            //
+            if ( 0 != generation % m_options.prune_interval ) {
+                continue;
+            }
+
+            if ( 0 == stats.population && 0 == stats.growth && !is_born(rules[lane], 0) ) {
+                candidate.outcome = rule_outcome_died;
+            }
+            else if ( m_options.max_population * area < double( stats.population ) ) {
+                candidate.outcome = rule_outcome_exploded;
+            }
+
+            if ( rule_outcome_survived != candidate.outcome ) {
+                --active;
+            }
+        }
+    }
+
+    auto pairs = std::vector<uint64_t>{};
+
+    m_stepper.count_adjacent(pairs);
+
+    for ( auto lane = uint32_t{ 0 }; lane < count; ++lane ) {
+        finish( rules[lane], candidates[lane], m_stepper.stats(lane).population, pairs[lane], results[lane] );
+    }
+}
+
+void RuleSearch::finish(const AutomatRule& rule, const Candidate& candidate, uint64_t population,
+                        uint64_t pairs, RankedRule& result) const noexcept
+{
+    const auto area    = double( m_seed.width() ) * m_seed.height();
+    const auto samples = double( std::max(candidate.sample_count, 1u) );
+    const auto mean    = candidate.population_sum / samples;
+
+    auto& metrics = result.metrics;
+
+    metrics.population_mean     = float( mean );
+    metrics.population_variance = float( std::max( 0.0, candidate.population_squares / samples - mean * mean ) );
+    metrics.transition_fraction = float( candidate.transition_sum / samples );
+    metrics.outcome             = candidate.outcome;
+    metrics.generation_count    = candidate.generation_count;
+    metrics.period              = shortest_period(candidate.history);
+
+    // • Correlation of alive between adjacent cells: pairs counts two
+    //      neighbors per cell
+    //
+    const auto p = double( population ) / area;
+    const auto q = double( pairs ) / (2.0 * area);
+
+    metrics.autocorrelation = ( 0.0 < p && p < 1.0 ) ? float( (q - p * p) / (p - p * p) ) : 0.0f;
+
+    result.rule  = rule;
+    result.score = 0.0f;
+
+    if ( rule_outcome_survived != candidate.outcome ) {
+        return;
+    }
+
+    const auto deviation = std::sqrt( double( metrics.population_variance ) );
+    const auto variation = ( 0.0 < mean ) ? deviation / mean : 0.0;
+    const auto structure = 0.5 + 0.5 * std::max( 0.0, double( metrics.autocorrelation ) );
+    const auto half      = std::max( 1.0, 0.5 * m_options.cycle_window );
+    const auto cycle     = ( 0 == metrics.period ) ? 1.0 : std::min( 1.0, metrics.period / half );
+
+    result.score = float( metrics.transition_fraction * structure * cycle / (1.0 + variation) );
+}
+
+} // namespace field
@@ -0,0 +1,192 @@
+//
+//  RuleSearch.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/BatchStepper.hpp>
+#include <Field/Grid.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+
+#include <cstdint>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Seeding
+//===------------------------------------------------------------------------===
+
+// • Host description of a FieldInitialization: count copies of the base
+//      region, each offset from the last. Composition.mm converts between
+//      the two, so that the search builds without the simd headers.
+//
+struct FieldSeed
+{
+    uint32_t    field_width;
+    uint32_t    field_height;
+    FieldRegion base_region;
+    int32_t     offset_x;
+    int32_t     offset_y;
+    uint32_t    count;
+};
+
+// • Alive cells where init_field_vertex draws, clipped to the field, over
+//      a cleared field (throws when the grid is not the seed's field size)
+//
+void seed_field(const FieldSeed& seed, Grid& grid) noexcept(false);
+
+//===------------------------------------------------------------------------===
+// • Rule space
+//===------------------------------------------------------------------------===
+
+// • Every Moore born and survive mask not born on zero neighbors, with the
+//      durations and boundary of base
+//
+std::vector<AutomatRule> enumerate_rules(const AutomatRule& base) noexcept(false);
+
+// • Random Moore masks not born on zero neighbors, with durations up to those
+//      of base and the boundary of base
+//
+std::vector<AutomatRule> sample_rules(const AutomatRule& base, uint32_t count, uint64_t seed) noexcept(false);
+
+//===------------------------------------------------------------------------===
+// • RuleMetrics
+//
+//  Streaming measurements of one candidate after warm-up. Population and
+//  transitions are fractions of the field per generation. Autocorrelation
+//  is the correlation of alive between adjacent cells at the end of the
+//  run, from -1 to 1. The period is the shortest with which the population
+//  and transition counts repeat over the final window, which divides the
+//  period of a cycling field, or 0 when they do not repeat.
+//===------------------------------------------------------------------------===
+
+enum : uint32_t
+{
+    rule_outcome_survived = 0,
+    rule_outcome_died     = 1,
+    rule_outcome_exploded = 2
+};
+
+struct RuleMetrics
+{
+    float       population_mean;
+    float       population_variance;
+    float       transition_fraction;
+    float       autocorrelation;
+    uint32_t    period;
+    uint32_t    outcome;
+    uint32_t    generation_count;   // stepped before completion or pruning
+};
+
+struct RankedRule
+{
+    AutomatRule rule;
+    RuleMetrics metrics;
+    float       score;
+};
+
+//===------------------------------------------------------------------------===
+// • RuleSearchOptions
+//===------------------------------------------------------------------------===
+
+struct RuleSearchOptions
+{
+    uint32_t    generation_count = 256;     // per candidate
+    uint32_t    warmup_count     = 32;      // before metrics accumulate
+    uint32_t    prune_interval   = 8;
+    uint32_t    cycle_window     = 32;
+    float       max_population   = 0.85f;   // fraction beyond which a candidate has exploded
+};
+
+//===------------------------------------------------------------------------===
+//
+// • RuleSearch
+//
+//  Runs candidate rules from the seed of a field initialization, 64 at a
+//  time on a BatchStepper, and ranks them by a texture score. Every prune
+//  interval, candidates that have died out (nothing alive, nothing growing
+//  and not born on zero neighbors) or exploded past the population limit
+//  are dropped, and a batch ends early once all of its candidates have.
+//
+//  The score favors sustained activity with spatial structure: the
+//  transition fraction, weighted up by positive autocorrelation, down by
+//  the population's coefficient of variation, and down for short periods,
+//  where a static field has period 1. Pruned candidates score zero.
+//
+//===------------------------------------------------------------------------===
+
+class RuleSearch
+{
+public:
+
+    // • Initialization (0 workers = one per hardware thread)
+    //
+    RuleSearch(const FieldSeed& seed, const RuleSearchOptions& options,
+               uint32_t worker_count = 0) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr const FieldSeed& seed(void) const noexcept
+    {
+        return m_field_seed;
+    }
+
+    constexpr const RuleSearchOptions& options(void) const noexcept
+    {
+        return m_options;
+    }
+
+    // • Methods : candidates ranked best first (throws for Larger than Life,
+    //      non-Moore, bounded or stochastic rules)
+    //
+    std::vector<RankedRule> run(const std::vector<AutomatRule>& rules) noexcept(false);
+
+private:
+
+    // • Per-candidate accumulation (private)
+    //
+    struct Candidate
+    {
+        double                  population_sum;
+        double                  population_squares;
+        double                  transition_sum;
+        uint32_t                sample_count;
+        uint32_t                outcome;
+        uint32_t                generation_count;
+        std::vector<uint64_t>   history;    // population and transitions, final window
+    };
+
+    void run_batch(const AutomatRule* rules, uint32_t count, RankedRule* results) noexcept(false);
+    void finish(const AutomatRule& rule, const Candidate& candidate, uint64_t population,
+                uint64_t pairs, RankedRule& result) const noexcept;
+
+    // • Data members
+    //
+    FieldSeed               m_field_seed;
+    RuleSearchOptions       m_options;
+    Grid                    m_seed;
+    BatchStepper            m_stepper;
+};
+
+} // namespace field
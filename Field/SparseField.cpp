@@ -0,0 +1,504 @@
+//
+//  SparseField.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/SparseField.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <bit>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+constexpr auto chunk_shift  = static_cast<uint32_t>( std::countr_zero(SparseField::chunk_side) );
+constexpr auto chunk_mask   = int64_t{ SparseField::chunk_side - 1u };
+constexpr auto apron_stride = SparseField::chunk_side + 2u;
+
+static_assert( std::has_single_bit(SparseField::chunk_side), "Chunk side must be a power of two" );
+
+constexpr size_t initial_slot_count = 64;
+
+constexpr uint64_t mix(uint64_t value) noexcept
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdull;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ull;
+    value ^= value >> 33;
+
+    return value;
+}
+
+// • Chunk coordinate and index within the chunk of a cell coordinate
+//
+constexpr int64_t chunk_coordinate(int64_t coordinate) noexcept
+{
+    return coordinate >> chunk_shift;
+}
+
+// • Chunks whose cells lie within the coordinate limit
+//
+constexpr auto chunk_limit = chunk_coordinate(SparseField::coordinate_limit);
+
+constexpr bool is_within_limit(int64_t coordinate) noexcept
+{
+    return -SparseField::coordinate_limit <= coordinate && coordinate < SparseField::coordinate_limit;
+}
+
+constexpr uint32_t local_coordinate(int64_t coordinate) noexcept
+{
+    return static_cast<uint32_t>( coordinate & chunk_mask );
+}
+
+constexpr bool is_quiet(const FieldValue& value) noexcept
+{
+    return 0 == value.alive && 0 == value.step;
+}
+
+// • Rows or columns of a chunk next to the neighbor at offset -1, 0 or 1
+//
+struct Span
+{
+    uint32_t    begin;
+    uint32_t    end;
+};
+
+constexpr Span edge_span(int offset) noexcept
+{
+    return ( offset < 0 ) ? Span{ 0, 1 }
+         : ( 0 < offset ) ? Span{ SparseField::chunk_side - 1u, SparseField::chunk_side }
+         :                  Span{ 0, SparseField::chunk_side };
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+SparseField::SparseField(const AutomatRule& rule) noexcept(false)
+    :
+        m_rule      { rule },
+        m_generation{ 0    },
+        m_current   { 0    }
+{
+    if ( is_larger_than_life(rule) || !is_moore(rule) || is_born(rule, 0) || is_stochastic(rule) ) {
+        throw false;
+    }
+
+    m_slots.assign( initial_slot_count, Slot{ 0, 0, empty_slot } );
+    m_apron.resize( size_t{ apron_stride } * apron_stride );
+}
+
+//===------------------------------------------------------------------------===
+// • Accessors
+//===------------------------------------------------------------------------===
+
+FieldValue SparseField::value(int64_t x, int64_t y) const noexcept
+{
+    const auto chunk = find( chunk_coordinate(x), chunk_coordinate(y) );
+
+    if ( empty_slot == chunk ) {
+        return FieldValue{};
+    }
+
+    return m_chunks[chunk]->cells[m_current][local_coordinate(y) * chunk_side + local_coordinate(x)];
+}
+
+std::optional<SparseBounds> SparseField::bounds(void) const noexcept
+{
+    if ( m_chunks.empty() ) {
+        return std::nullopt;
+    }
+
+    auto left   = m_chunks.front()->cx;
+    auto top    = m_chunks.front()->cy;
+    auto right  = left;
+    auto bottom = top;
+
+    for ( const auto& chunk : m_chunks )
+    {
+        left   = std::min(left,   chunk->cx);
+        top    = std::min(top,    chunk->cy);
+        right  = std::max(right,  chunk->cx);
+        bottom = std::max(bottom, chunk->cy);
+    }
+
+    return SparseBounds {
+        .left   = left * chunk_side,
+        .top    = top  * chunk_side,
+        .right  = ( right  + 1 ) * chunk_side,
+        .bottom = ( bottom + 1 ) * chunk_side
+    };
+}
+
+//===------------------------------------------------------------------------===
+// • Methods
+//===------------------------------------------------------------------------===
+
+void SparseField::set(int64_t x, int64_t y, const FieldValue& value) noexcept(false)
+{
+    if ( !is_within_limit(x) || !is_within_limit(y) ) {
+        throw false;
+    }
+
+    const auto cx = chunk_coordinate(x);
+    const auto cy = chunk_coordinate(y);
+
+    auto chunk = find(cx, cy);
+
+    if ( empty_slot == chunk )
+    {
+        if ( is_quiet(value) ) {
+            return;
+        }
+
+        chunk = insert(cx, cy);
+    }
+
+    m_chunks[chunk]->cells[m_current][local_coordinate(y) * chunk_side + local_coordinate(x)] = value;
+}
+
+void SparseField::load(const Grid& grid, int64_t left, int64_t top) noexcept(false)
+{
+    const auto within = is_within_limit(left) && left <= coordinate_limit - int64_t{ grid.width() }
+                     && is_within_limit(top)  && top  <= coordinate_limit - int64_t{ grid.height() };
+
+    if ( !within ) {
+        throw false;
+    }
+
+    for ( auto y = uint32_t{ 0 }; y < grid.height(); ++y )
+    {
+        const auto* row = grid.row(y);
+
+        for ( auto x = uint32_t{ 0 }; x < grid.width(); ++x ) {
+            set( left + x, top + y, row[x] );
+        }
+    }
+}
+
+void SparseField::store(Grid& grid, int64_t left, int64_t top) const noexcept
+{
+    for ( auto y = uint32_t{ 0 }; y < grid.height(); ++y )
+    {
+        const auto cy    = chunk_coordinate(top + y);
+        const auto local = local_coordinate(top + y) * chunk_side;
+        auto*      row   = grid.row(y);
+
+        // • One lookup per chunk the row crosses
+        //
+        for ( auto x = uint32_t{ 0 }; x < grid.width(); )
+        {
+            const auto first = local_coordinate(left + x);
+            const auto count = std::min( chunk_side - first, grid.width() - x );
+            const auto chunk = find( chunk_coordinate(left + x), cy );
+
+            if ( empty_slot == chunk )
+            {
+                std::fill_n( row + x, count, FieldValue{} );
+            }
+            else
+            {
+                const auto* cells = m_chunks[chunk]->cells[m_current].data() + local + first;
+                std::copy_n( cells, count, row + x );
+            }
+
+            x += count;
+        }
+    }
+}
+
+void SparseField::step(void) noexcept(false)
+{
+    grow();
+
+    for ( auto& chunk : m_chunks ) {
+        step_chunk(*chunk);
+    }
+
+    m_current ^= 1u;
+    ++m_generation;
+
+    // • Free quiet chunks; erasing moves the last chunk, which has been seen
+    //
+    for ( auto chunk = static_cast<uint32_t>( m_chunks.size() ); 0 < chunk--; )
+    {
+        if ( m_chunks[chunk]->quiet ) {
+            erase(chunk);
+        }
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Hash map
+//===------------------------------------------------------------------------===
+
+size_t SparseField::home_slot(int64_t cx, int64_t cy) const noexcept
+{
+    const auto key = mix( static_cast<uint64_t>(cx) ) ^ static_cast<uint64_t>(cy);
+
+    return static_cast<size_t>( mix(key) ) & ( m_slots.size() - 1u );
+}
+
+uint32_t SparseField::find(int64_t cx, int64_t cy) const noexcept
+{
+    const auto mask = m_slots.size() - 1u;
+
+    for ( auto slot = home_slot(cx, cy); ; slot = (slot + 1u) & mask )
+    {
+        const auto& entry = m_slots[slot];
+
+        if ( empty_slot == entry.chunk || ( cx == entry.cx && cy == entry.cy ) ) {
+            return entry.chunk;
+        }
+    }
+}
+
+uint32_t SparseField::insert(int64_t cx, int64_t cy) noexcept(false)
+{
+    if ( const auto chunk = find(cx, cy); empty_slot != chunk ) {
+        return chunk;
+    }
+
+    if ( m_slots.size() < 2u * ( m_chunks.size() + 1u ) ) {
+        rehash( 2u * m_slots.size() );
+    }
+
+    // • Value-initialized: dead, settled cells
+    //
+    auto created = std::make_unique<Chunk>();
+
+    created->cx = cx;
+    created->cy = cy;
+
+    const auto chunk = static_cast<uint32_t>( m_chunks.size() );
+    const auto mask  = m_slots.size() - 1u;
+
+    auto slot = home_slot(cx, cy);
+
+    while ( empty_slot != m_slots[slot].chunk ) {
+        slot = (slot + 1u) & mask;
+    }
+
+    m_chunks.push_back( std::move(created) );
+    m_slots[slot] = Slot{ cx, cy, chunk };
+
+    return chunk;
+}
+
+// • Backward-shift deletion keeps every probe sequence unbroken without
+//      tombstones; the last chunk then moves into the freed index
+//
+void SparseField::erase(uint32_t chunk) noexcept
+{
+    const auto mask = m_slots.size() - 1u;
+
+    const auto slot_of = [&](uint32_t index) noexcept
+    {
+        auto slot = home_slot( m_chunks[index]->cx, m_chunks[index]->cy );
+
+        while ( m_slots[slot].chunk != index ) {
+            slot = (slot + 1u) & mask;
+        }
+
+        return slot;
+    };
+
+    auto hole = slot_of(chunk);
+
+    for ( auto next = (hole + 1u) & mask; empty_slot != m_slots[next].chunk; next = (next + 1u) & mask )
+    {
+        // • An entry may fill the hole when the hole lies between its home
+        //      slot and where it is now
+        //
+        const auto home = home_slot( m_slots[next].cx, m_slots[next].cy );
+
+        if ( ( (hole - home) & mask ) < ( (next - home) & mask ) )
+        {
+            m_slots[hole] = m_slots[next];
+            hole          = next;
+        }
+    }
+
+    m_slots[hole].chunk = empty_slot;
+
+    const auto last = static_cast<uint32_t>( m_chunks.size() - 1u );
+
+    if ( chunk != last )
+    {
+        m_slots[ slot_of(last) ].chunk = chunk;
+        m_chunks[chunk]                = std::move( m_chunks[last] );
+    }
+
+    m_chunks.pop_back();
+}
+
+void SparseField::rehash(size_t capacity) noexcept(false)
+{
+    m_slots.assign( capacity, Slot{ 0, 0, empty_slot } );
+
+    const auto mask = capacity - 1u;
+
+    for ( auto chunk = uint32_t{ 0 }; chunk < m_chunks.size(); ++chunk )
+    {
+        const auto cx   = m_chunks[chunk]->cx;
+        const auto cy   = m_chunks[chunk]->cy;
+        auto       slot = home_slot(cx, cy);
+
+        while ( empty_slot != m_slots[slot].chunk ) {
+            slot = (slot + 1u) & mask;
+        }
+
+        m_slots[slot] = Slot{ cx, cy, chunk };
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Stepping
+//===------------------------------------------------------------------------===
+
+// • Creates the missing neighbors an alive edge or corner cell could reach
+//
+void SparseField::grow(void) noexcept(false)
+{
+    const auto count = m_chunks.size();
+
+    for ( auto index = size_t{ 0 }; index < count; ++index )
+    {
+        const auto& chunk = *m_chunks[index];
+        const auto& cells = chunk.cells[m_current];
+        const auto  cx    = chunk.cx;
+        const auto  cy    = chunk.cy;
+
+        for ( auto dy = -1; dy <= 1; ++dy )
+        {
+            for ( auto dx = -1; dx <= 1; ++dx )
+            {
+                if ( ( 0 == dx && 0 == dy ) || empty_slot != find(cx + dx, cy + dy) ) {
+                    continue;
+                }
+
+                const auto rows = edge_span(dy);
+                const auto cols = edge_span(dx);
+
+                auto reaches = false;
+
+                for ( auto y = rows.begin; y < rows.end && !reaches; ++y )
+                {
+                    for ( auto x = cols.begin; x < cols.end; ++x ) {
+                        reaches |= ( 0 != cells[y * chunk_side + x].alive );
+                    }
+                }
+
+                if ( reaches )
+                {
+                    // • The chunk would hold cells beyond the limit
+                    //
+                    if ( cx + dx < -chunk_limit || chunk_limit <= cx + dx
+                      || cy + dy < -chunk_limit || chunk_limit <= cy + dy )
+                    {
+                        throw false;
+                    }
+
+                    insert(cx + dx, cy + dy);
+                }
+            }
+        }
+    }
+}
+
+void SparseField::step_chunk(Chunk& chunk) noexcept
+{
+    // • Alive values of the chunk and a one cell border from its neighbors,
+    //      dead where there is no neighbor
+    //
+    constexpr auto side = int{ chunk_side };
+
+    for ( auto dy = -1; dy <= 1; ++dy )
+    {
+        const auto rows = edge_span(-dy);
+
+        for ( auto dx = -1; dx <= 1; ++dx )
+        {
+            const auto cols     = edge_span(-dx);
+            const auto neighbor = find(chunk.cx + dx, chunk.cy + dy);
+            const auto width    = cols.end - cols.begin;
+
+            for ( auto y = rows.begin; y < rows.end; ++y )
+            {
+                auto* apron = m_apron.data() + size_t( int( y ) + 1 + dy * side ) * apron_stride
+                                             + size_t( int( cols.begin ) + 1 + dx * side );
+
+                if ( empty_slot == neighbor )
+                {
+                    std::fill_n( apron, width, uint8_t{ 0 } );
+                    continue;
+                }
+
+                const auto* cells = m_chunks[neighbor]->cells[m_current].data() + y * chunk_side + cols.begin;
+
+                for ( auto x = uint32_t{ 0 }; x < width; ++x ) {
+                    apron[x] = cells[x].alive;
+                }
+            }
+        }
+    }
+
+    // • Step into the next cells
+    //
+    const auto& cells = chunk.cells[m_current];
+    auto&       next  = chunk.cells[m_current ^ 1u];
+
+    auto quiet = true;
+
+    for ( auto y = uint32_t{ 0 }; y < chunk_side; ++y )
+    {
+        const auto* u = m_apron.data() + y * apron_stride;
+        const auto* m = u + apron_stride;
+        const auto* l = m + apron_stride;
+
+        for ( auto x = uint32_t{ 0 }; x < chunk_side; ++x )
+        {
+            const auto neighbor_count = uint32_t{ u[x] } + u[x + 1] + u[x + 2]
+                                      + uint32_t{ m[x] }            + m[x + 2]
+                                      + uint32_t{ l[x] } + l[x + 1] + l[x + 2];
+
+            const auto value = field::step( cells[y * chunk_side + x], neighbor_count, m_rule );
+
+            next[y * chunk_side + x] = value;
+            quiet                   &= is_quiet(value);
+        }
+    }
+
+    chunk.quiet = quiet;
+}
+
+} // namespace field
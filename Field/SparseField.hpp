@@ -0,0 +1,173 @@
+//
+//  SparseField.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+#include <Shaders/Data/FieldValue.hpp>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • SparseBounds
+//
+//  Cells [left, right) x [top, bottom) of the allocated chunks
+//===------------------------------------------------------------------------===
+
+struct SparseBounds
+{
+    int64_t     left;
+    int64_t     top;
+    int64_t     right;
+    int64_t     bottom;
+};
+
+//===------------------------------------------------------------------------===
+//
+// • SparseField
+//
+//  Unbounded field stored as chunk_side square chunks in an open-addressing
+//  hash map keyed by chunk coordinates, so memory follows the live area
+//  rather than the bounding box. Everything outside the chunks is dead and
+//  settled.
+//
+//  Cells lie in [-coordinate_limit, coordinate_limit) on both axes, which
+//  keeps chunk coordinates and bounds clear of overflow. Setting or loading
+//  a cell beyond it throws, as does a step that would grow a chunk past it.
+//
+//  A chunk is created when an alive cell on the edge of a neighbor could
+//  reach it, and freed once a step leaves it quiet: no alive cells and none
+//  counting down. Cells of a freed chunk read as FieldValue{}, which drops
+//  only the durations of settled dead cells, which nothing reads.
+//
+//  Moore neighborhood only, and a rule may not be born on zero neighbors,
+//  since the empty plane would then come alive everywhere at once.
+//
+//===------------------------------------------------------------------------===
+
+class SparseField
+{
+public:
+
+    // • Constants
+    //
+    static constexpr uint32_t chunk_side = 64;
+    static constexpr uint32_t chunk_area = chunk_side * chunk_side;
+
+    static constexpr int64_t  coordinate_limit = int64_t{ 1 } << 62;
+
+    // • Initialization (throws for Larger than Life and non-Moore rules, rules
+    //      born on 0 and stochastic rules)
+    //
+    explicit SparseField(const AutomatRule& rule) noexcept(false);
+
+    // • Accessors
+    //
+    constexpr const AutomatRule& rule(void) const noexcept
+    {
+        return m_rule;
+    }
+
+    constexpr uint64_t generation(void) const noexcept
+    {
+        return m_generation;
+    }
+
+    size_t chunk_count(void) const noexcept
+    {
+        return m_chunks.size();
+    }
+
+    FieldValue value(int64_t x, int64_t y) const noexcept;
+
+    std::optional<SparseBounds> bounds(void) const noexcept;
+
+    // • Methods : cells (setting a settled dead cell never creates a chunk)
+    //
+    void set(int64_t x, int64_t y, const FieldValue& value) noexcept(false);
+
+    // • Methods : transfer of the grid-sized window at (left, top), which is
+    //      loaded only when it lies wholly within the limit
+    //
+    void load(const Grid& grid, int64_t left, int64_t top) noexcept(false);
+    void store(Grid& grid, int64_t left, int64_t top) const noexcept;
+
+    // • Methods : step
+    //
+    void step(void) noexcept(false);
+
+private:
+
+    // • Chunks (private)
+    //
+    using Cells = std::array<FieldValue, chunk_area>;
+
+    struct Chunk
+    {
+        int64_t     cx;
+        int64_t     cy;
+        bool        quiet;          // after the last step
+        Cells       cells[2];       // current and next generation
+    };
+
+    struct Slot
+    {
+        int64_t     cx;
+        int64_t     cy;
+        uint32_t    chunk;          // index into m_chunks, or empty_slot
+    };
+
+    static constexpr uint32_t empty_slot = ~uint32_t{ 0 };
+
+    // • Hash map (private)
+    //
+    size_t   home_slot(int64_t cx, int64_t cy) const noexcept;
+    uint32_t find(int64_t cx, int64_t cy) const noexcept;
+    uint32_t insert(int64_t cx, int64_t cy) noexcept(false);
+    void     erase(uint32_t chunk) noexcept;
+    void     rehash(size_t capacity) noexcept(false);
+
+    // • Stepping (private)
+    //
+    void grow(void) noexcept(false);
+    void step_chunk(Chunk& chunk) noexcept;
+
+    // • Data members
+    //
+    AutomatRule                         m_rule;
+    uint64_t                            m_generation;
+    uint32_t                            m_current;      // index of the current cells
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<Slot>                   m_slots;        // power of two, at most half full
+    std::vector<uint8_t>                m_apron;        // (chunk_side + 2)^2 alive values
+};
+
+} // namespace field
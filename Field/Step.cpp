@@ -0,0 +1,93 @@
+//
+//  Step.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/Step.hpp>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Field step (scalar reference)
+//===------------------------------------------------------------------------===
+
+void step(const Grid& source, Grid& dest, const AutomatRule& rule, uint64_t generation) noexcept(false)
+{
+    if ( source.width() != dest.width() || source.height() != dest.height() ) {
+        throw false;
+    }
+
+    const auto width  = static_cast<int>( source.width() );
+    const auto height = static_cast<int>( source.height() );
+    const auto radius = static_cast<int>( neighborhood_radius(rule) );
+    const auto chance = is_stochastic(rule);
+
+    // • Alive value of any cell, beyond the edges through the boundary
+    //
+    const auto alive = [&](int x, int y) noexcept -> uint32_t
+    {
+        const auto bx = boundary_index(x, width,  rule.boundary);
+        const auto by = boundary_index(y, height, rule.boundary);
+
+        return ( bx < 0 || by < 0 ) ? 0u : source.at(bx, by).alive;
+    };
+
+    // • Whether an offset within the square lies in the neighborhood of a
+    //      cell of row y: the hexagonal grid shifts odd rows half a cell right
+    //
+    const auto contains = [&](int dx, int dy, int y) noexcept -> bool
+    {
+        if ( is_moore(rule) ) {
+            return true;
+        }
+        if ( topology_von_neumann == rule.topology ) {
+            return 0 == dx || 0 == dy;
+        }
+
+        return 0 == dy || ( (y & 1) ? 0 <= dx : dx <= 0 );
+    };
+
+    for ( auto y = 0; y < height; ++y )
+    {
+        for ( auto x = 0; x < width; ++x )
+        {
+            auto neighbor_count = uint32_t{ 0 };
+
+            for ( auto dy = -radius; dy <= radius; ++dy )
+            {
+                for ( auto dx = -radius; dx <= radius; ++dx )
+                {
+                    if ( contains(dx, dy, y) ) {
+                        neighbor_count += alive(x + dx, y + dy);
+                    }
+                }
+            }
+
+            const auto& value = source.at(x, y);
+            const auto  draw  = chance ? cell_random(rule.seed, generation, x, y) : 0u;
+
+            dest.at(x, y) = step( value, neighbor_count - value.alive, rule, draw );
+        }
+    }
+}
+
+} // namespace field
@@ -0,0 +1,138 @@
+//
+//  Step.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Shaders/Data/AutomatRule.hpp>
+#include <Shaders/Data/CellRandom.hpp>
+#include <Shaders/Data/FieldValue.hpp>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • Rule utilities
+//===------------------------------------------------------------------------===
+
+constexpr bool is_larger_than_life(const AutomatRule& rule) noexcept
+{
+    return 1u < rule.radius;
+}
+
+constexpr bool is_torus(const AutomatRule& rule) noexcept
+{
+    return boundary_dead != rule.boundary && boundary_mirror != rule.boundary;
+}
+
+// • The square neighborhood: Moore, or Larger than Life at any radius
+//
+constexpr bool is_moore(const AutomatRule& rule) noexcept
+{
+    return is_larger_than_life(rule) || topology_moore == rule.topology;
+}
+
+constexpr bool is_stochastic(const AutomatRule& rule) noexcept
+{
+    return 0 != rule.born_chance || 0 != rule.survive_chance;
+}
+
+constexpr uint32_t neighborhood_radius(const AutomatRule& rule) noexcept
+{
+    return is_larger_than_life(rule) ? rule.radius : 1u;
+}
+
+constexpr bool is_born(const AutomatRule& rule, uint32_t neighbor_count) noexcept
+{
+    if ( is_larger_than_life(rule) ) {
+        return rule.born_min <= neighbor_count && neighbor_count <= rule.born_max;
+    }
+
+    return 0 != ( rule.born & (1u << neighbor_count) );
+}
+
+constexpr bool survives(const AutomatRule& rule, uint32_t neighbor_count) noexcept
+{
+    if ( is_larger_than_life(rule) ) {
+        return rule.survive_min <= neighbor_count && neighbor_count <= rule.survive_max;
+    }
+
+    return 0 != ( rule.survive & (1u << neighbor_count) );
+}
+
+//===------------------------------------------------------------------------===
+// • Single cell step
+//
+//  The reference behavior for every host engine, identical to step_field in
+//  StepField.metal. The draw is the cell's cell_random for a stochastic
+//  rule; the default of 0 passes every chance.
+//===------------------------------------------------------------------------===
+
+constexpr FieldValue step(FieldValue value, uint32_t neighbor_count, const AutomatRule& rule,
+                          uint32_t draw = 0) noexcept
+{
+    if ( 0 < value.step )
+    {
+        // • Next step
+        //
+        --value.step;
+    }
+    else if ( value.alive )
+    {
+        // • Mature
+        //
+        if ( !survives(rule, neighbor_count) || !passes_chance(rule.survive_chance, draw) )
+        {
+            // Decline
+            value.step  = value.duration = rule.decline_duration;
+            value.alive = 0;
+        }
+    }
+    else
+    {
+        // • Fallow
+        //
+        if ( is_born(rule, neighbor_count) && passes_chance(rule.born_chance, draw) )
+        {
+            // Growth
+            value.step  = value.duration = rule.growth_duration;
+            value.alive = 1;
+        }
+    }
+
+    return value;
+}
+
+//===------------------------------------------------------------------------===
+// • Field step (scalar reference)
+//
+//  Steps every cell one value at a time, counting the neighborhood of each
+//  cell directly whatever its radius or topology and mapping every neighbor
+//  through the rule's boundary. This is the slowest path and exists to
+//  validate the optimized engines. The generation is that of source, which keys the
+//  draws of a stochastic rule
+//===------------------------------------------------------------------------===
+
+void step(const Grid& source, Grid& dest, const AutomatRule& rule, uint64_t generation = 0) noexcept(false);
+
+} // namespace field
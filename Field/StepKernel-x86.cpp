@@ -0,0 +1,475 @@
+//
+//  StepKernel-x86.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/StepKernel.hpp>
+
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+
+#include <immintrin.h>
+
+//===------------------------------------------------------------------------===
+//
+// • x86 step kernels
+//
+//  Each variant is compiled for its own instruction set with a target
+//  attribute, so one build serves every processor generation and the choice
+//  is made at startup (see best_step_kernel_isa). Cells are processed one
+//  byte per lane:
+//
+//  The neighbor sum is unrolled for the topology and row parity, which are
+//  template parameters, so each variant is a fixed stencil.
+//
+//      settled    = step == 0
+//      growth     = settled & !alive & born[n]
+//      decline    = settled &  alive & !survive[n]
+//      transition = growth | decline
+//
+//      alive'    = alive ^ transition
+//      d         = growth ? growth_duration : decline_duration
+//      step'     = transition ? d : saturating(step - 1)
+//      duration' = transition ? d : duration
+//
+//  Counted variants also sum alive', growth, decline and step' != 0 from
+//  the same registers: with psadbw into 64-bit lanes, or as popcounts of
+//  the AVX-512 masks, reduced once per row.
+//
+//===------------------------------------------------------------------------===
+
+//===------------------------------------------------------------------------===
+// • namespace field::detail
+//===------------------------------------------------------------------------===
+
+namespace field::detail
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+// • Byte lookup table from neighbor count (0...8) to 0xff where the count
+//      is set in the mask, for pshufb
+//
+struct CountTable
+{
+    alignas(16) uint8_t bytes[16];
+};
+
+constexpr CountTable make_count_table(uint16_t mask) noexcept
+{
+    auto table = CountTable{};
+
+    for ( auto count = 0u; count < 9u; ++count )
+    {
+        table.bytes[count] = ( mask & (1u << count) ) ? 0xff : 0x00;
+    }
+
+    return table;
+}
+
+// • Sum of the two 64-bit lanes of psadbw sums
+//
+__attribute__(( target("sse2") ))
+uint32_t sum_lanes(__m128i sums) noexcept
+{
+    return static_cast<uint32_t>( _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32( _mm_unpackhi_epi64(sums, sums) ) );
+}
+
+// • Adds a row's psadbw sums to its counts
+//
+__attribute__(( target("sse2") ))
+void add_sums(StepCounts& counts, __m128i population, __m128i births, __m128i deaths, __m128i transitioning) noexcept
+{
+    counts.population    += sum_lanes(population);
+    counts.births        += sum_lanes(births);
+    counts.deaths        += sum_lanes(deaths);
+    counts.transitioning += sum_lanes(transitioning);
+}
+
+// • AVX2 psadbw sums folded to two lanes
+//
+__attribute__(( target("avx2") ))
+__m128i fold_lanes(__m256i sums) noexcept
+{
+    return _mm_add_epi64( _mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1) );
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • SSE2 (16 cells)
+//
+//  No byte shuffle is available, so count membership is built from one
+//  compare per count present in the rule
+//===------------------------------------------------------------------------===
+
+template <uint8_t Topology_, bool OddRow_, bool Counted_>
+__attribute__(( target("sse2") ))
+void step_row_sse2(const StepRow& row, uint32_t width, const AutomatRule& rule) noexcept
+{
+    const auto zero    = _mm_setzero_si128();
+    const auto one     = _mm_set1_epi8(1);
+    const auto growth_duration  = _mm_set1_epi8( static_cast<char>(rule.growth_duration) );
+    const auto decline_duration = _mm_set1_epi8( static_cast<char>(rule.decline_duration) );
+
+    __m128i born_counts[9];
+    __m128i survive_counts[9];
+
+    auto born_count    = 0u;
+    auto survive_count = 0u;
+
+    for ( auto count = 0u; count < 9u; ++count )
+    {
+        if ( rule.born    & (1u << count) ) born_counts[born_count++]       = _mm_set1_epi8( static_cast<char>(count) );
+        if ( rule.survive & (1u << count) ) survive_counts[survive_count++] = _mm_set1_epi8( static_cast<char>(count) );
+    }
+
+    auto population    = zero;
+    auto births        = zero;
+    auto deaths        = zero;
+    auto transitioning = zero;
+
+    auto x = uint32_t{ 0 };
+
+    for ( ; x + 16u <= width; x += 16u )
+    {
+        // • Neighbor count
+        //
+        const auto ul = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.upper  + x - 1) );
+        const auto uc = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.upper  + x    ) );
+        const auto ur = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.upper  + x + 1) );
+        const auto ml = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.middle + x - 1) );
+        const auto mc = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.middle + x    ) );
+        const auto mr = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.middle + x + 1) );
+        const auto ll = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.lower  + x - 1) );
+        const auto lc = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.lower  + x    ) );
+        const auto lr = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.lower  + x + 1) );
+
+        auto n = __m128i{};
+
+        if constexpr ( topology_von_neumann == Topology_ ) {
+            n = _mm_add_epi8( _mm_add_epi8(uc, ml), _mm_add_epi8(mr, lc) );
+        }
+        else if constexpr ( topology_hexagonal == Topology_ && OddRow_ ) {
+            n = _mm_add_epi8( _mm_add_epi8( _mm_add_epi8(uc, ur), _mm_add_epi8(ml, mr) ), _mm_add_epi8(lc, lr) );
+        }
+        else if constexpr ( topology_hexagonal == Topology_ ) {
+            n = _mm_add_epi8( _mm_add_epi8( _mm_add_epi8(ul, uc), _mm_add_epi8(ml, mr) ), _mm_add_epi8(ll, lc) );
+        }
+        else {
+            n = _mm_add_epi8( _mm_add_epi8( _mm_add_epi8(ul, uc), _mm_add_epi8(ur, ml) ),
+                              _mm_add_epi8( _mm_add_epi8(mr, ll), _mm_add_epi8(lc, lr) ) );
+        }
+
+        auto born    = zero;
+        auto survive = zero;
+
+        for ( auto i = 0u; i < born_count; ++i )    born    = _mm_or_si128( born,    _mm_cmpeq_epi8(n, born_counts[i]) );
+        for ( auto i = 0u; i < survive_count; ++i ) survive = _mm_or_si128( survive, _mm_cmpeq_epi8(n, survive_counts[i]) );
+
+        // • Transitions
+        //
+        const auto step     = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.step     + x) );
+        const auto duration = _mm_loadu_si128( reinterpret_cast<const __m128i*>(row.duration + x) );
+
+        const auto settled = _mm_cmpeq_epi8(step, zero);
+        const auto alive   = _mm_cmpeq_epi8(mc, one);
+
+        const auto growth     = _mm_andnot_si128( alive,   _mm_and_si128(settled, born)  );
+        const auto decline    = _mm_andnot_si128( survive, _mm_and_si128(settled, alive) );
+        const auto transition = _mm_or_si128(growth, decline);
+
+        const auto next_duration = _mm_or_si128( _mm_and_si128(growth,  growth_duration),
+                                                 _mm_and_si128(decline, decline_duration) );
+
+        // • Results
+        //
+        const auto alive_out    = _mm_xor_si128( mc, _mm_and_si128(transition, one) );
+        const auto step_out     = _mm_or_si128( next_duration, _mm_andnot_si128(transition, _mm_subs_epu8(step, one)) );
+        const auto duration_out = _mm_or_si128( next_duration, _mm_andnot_si128(transition, duration) );
+
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(row.next_alive    + x), alive_out    );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(row.next_step     + x), step_out     );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(row.next_duration + x), duration_out );
+
+        if constexpr ( Counted_ )
+        {
+            population    = _mm_add_epi64( population,    _mm_sad_epu8(alive_out, zero) );
+            births        = _mm_add_epi64( births,        _mm_sad_epu8( _mm_and_si128(growth,  one), zero ) );
+            deaths        = _mm_add_epi64( deaths,        _mm_sad_epu8( _mm_and_si128(decline, one), zero ) );
+            transitioning = _mm_add_epi64( transitioning, _mm_sad_epu8( _mm_min_epu8(step_out, one), zero ) );
+        }
+    }
+
+    if constexpr ( Counted_ ) {
+        add_sums(*row.counts, population, births, deaths, transitioning);
+    }
+
+    step_row_scalar<Topology_, OddRow_, Counted_>(row, x, width, rule);
+}
+
+//===------------------------------------------------------------------------===
+// • AVX2 (32 cells)
+//
+//  Count membership is a single pshufb into a 16-byte table per mask
+//===------------------------------------------------------------------------===
+
+template <uint8_t Topology_, bool OddRow_, bool Counted_>
+__attribute__(( target("avx2") ))
+void step_row_avx2(const StepRow& row, uint32_t width, const AutomatRule& rule) noexcept
+{
+    const auto born_table    = make_count_table(rule.born);
+    const auto survive_table = make_count_table(rule.survive);
+
+    const auto born_lut    = _mm256_broadcastsi128_si256( _mm_load_si128( reinterpret_cast<const __m128i*>(born_table.bytes) ) );
+    const auto survive_lut = _mm256_broadcastsi128_si256( _mm_load_si128( reinterpret_cast<const __m128i*>(survive_table.bytes) ) );
+
+    const auto zero = _mm256_setzero_si256();
+    const auto one  = _mm256_set1_epi8(1);
+    const auto growth_duration  = _mm256_set1_epi8( static_cast<char>(rule.growth_duration) );
+    const auto decline_duration = _mm256_set1_epi8( static_cast<char>(rule.decline_duration) );
+
+    auto population    = zero;
+    auto births        = zero;
+    auto deaths        = zero;
+    auto transitioning = zero;
+
+    auto x = uint32_t{ 0 };
+
+    for ( ; x + 32u <= width; x += 32u )
+    {
+        // • Neighbor count
+        //
+        const auto ul = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.upper  + x - 1) );
+        const auto uc = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.upper  + x    ) );
+        const auto ur = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.upper  + x + 1) );
+        const auto ml = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.middle + x - 1) );
+        const auto mc = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.middle + x    ) );
+        const auto mr = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.middle + x + 1) );
+        const auto ll = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.lower  + x - 1) );
+        const auto lc = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.lower  + x    ) );
+        const auto lr = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.lower  + x + 1) );
+
+        auto n = __m256i{};
+
+        if constexpr ( topology_von_neumann == Topology_ ) {
+            n = _mm256_add_epi8( _mm256_add_epi8(uc, ml), _mm256_add_epi8(mr, lc) );
+        }
+        else if constexpr ( topology_hexagonal == Topology_ && OddRow_ ) {
+            n = _mm256_add_epi8( _mm256_add_epi8( _mm256_add_epi8(uc, ur), _mm256_add_epi8(ml, mr) ), _mm256_add_epi8(lc, lr) );
+        }
+        else if constexpr ( topology_hexagonal == Topology_ ) {
+            n = _mm256_add_epi8( _mm256_add_epi8( _mm256_add_epi8(ul, uc), _mm256_add_epi8(ml, mr) ), _mm256_add_epi8(ll, lc) );
+        }
+        else {
+            n = _mm256_add_epi8( _mm256_add_epi8( _mm256_add_epi8(ul, uc), _mm256_add_epi8(ur, ml) ),
+                                 _mm256_add_epi8( _mm256_add_epi8(mr, ll), _mm256_add_epi8(lc, lr) ) );
+        }
+
+        const auto born    = _mm256_shuffle_epi8(born_lut,    n);
+        const auto survive = _mm256_shuffle_epi8(survive_lut, n);
+
+        // • Transitions
+        //
+        const auto step     = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.step     + x) );
+        const auto duration = _mm256_loadu_si256( reinterpret_cast<const __m256i*>(row.duration + x) );
+
+        const auto settled = _mm256_cmpeq_epi8(step, zero);
+        const auto alive   = _mm256_cmpeq_epi8(mc, one);
+
+        const auto growth     = _mm256_andnot_si256( alive,   _mm256_and_si256(settled, born)  );
+        const auto decline    = _mm256_andnot_si256( survive, _mm256_and_si256(settled, alive) );
+        const auto transition = _mm256_or_si256(growth, decline);
+
+        const auto next_duration = _mm256_or_si256( _mm256_and_si256(growth,  growth_duration),
+                                                    _mm256_and_si256(decline, decline_duration) );
+
+        // • Results
+        //
+        const auto alive_out    = _mm256_xor_si256( mc, _mm256_and_si256(transition, one) );
+        const auto step_out     = _mm256_blendv_epi8( _mm256_subs_epu8(step, one), next_duration, transition );
+        const auto duration_out = _mm256_blendv_epi8( duration, next_duration, transition );
+
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>(row.next_alive    + x), alive_out    );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>(row.next_step     + x), step_out     );
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>(row.next_duration + x), duration_out );
+
+        if constexpr ( Counted_ )
+        {
+            population    = _mm256_add_epi64( population,    _mm256_sad_epu8(alive_out, zero) );
+            births        = _mm256_add_epi64( births,        _mm256_sad_epu8( _mm256_and_si256(growth,  one), zero ) );
+            deaths        = _mm256_add_epi64( deaths,        _mm256_sad_epu8( _mm256_and_si256(decline, one), zero ) );
+            transitioning = _mm256_add_epi64( transitioning, _mm256_sad_epu8( _mm256_min_epu8(step_out, one), zero ) );
+        }
+    }
+
+    if constexpr ( Counted_ )
+    {
+        add_sums( *row.counts, fold_lanes(population), fold_lanes(births),
+                  fold_lanes(deaths), fold_lanes(transitioning) );
+    }
+
+    step_row_scalar<Topology_, OddRow_, Counted_>(row, x, width, rule);
+}
+
+//===------------------------------------------------------------------------===
+// • AVX-512BW (64 cells)
+//
+//  Per-lane conditions live in mask registers, and the row remainder is
+//  handled with masked loads and stores instead of the scalar path
+//===------------------------------------------------------------------------===
+
+template <uint8_t Topology_, bool OddRow_, bool Counted_>
+__attribute__(( target("avx512f,avx512bw,popcnt") ))
+void step_row_avx512(const StepRow& row, uint32_t width, const AutomatRule& rule) noexcept
+{
+    const auto born_table    = make_count_table(rule.born);
+    const auto survive_table = make_count_table(rule.survive);
+
+    const auto born_lut    = _mm512_broadcast_i32x4( _mm_load_si128( reinterpret_cast<const __m128i*>(born_table.bytes) ) );
+    const auto survive_lut = _mm512_broadcast_i32x4( _mm_load_si128( reinterpret_cast<const __m128i*>(survive_table.bytes) ) );
+
+    const auto one = _mm512_set1_epi8(1);
+    const auto growth_duration  = _mm512_set1_epi8( static_cast<char>(rule.growth_duration) );
+    const auto decline_duration = _mm512_set1_epi8( static_cast<char>(rule.decline_duration) );
+
+    auto counts = StepCounts{};
+
+    for ( auto x = uint32_t{ 0 }; x < width; x += 64u )
+    {
+        const auto remaining = width - x;
+        const auto lanes     = ( 64u <= remaining ) ? ~__mmask64{ 0 } : ( __mmask64{ 1 } << remaining ) - 1u;
+
+        // • Neighbor count
+        //
+        const auto ul = _mm512_maskz_loadu_epi8( lanes, row.upper  + x - 1 );
+        const auto uc = _mm512_maskz_loadu_epi8( lanes, row.upper  + x     );
+        const auto ur = _mm512_maskz_loadu_epi8( lanes, row.upper  + x + 1 );
+        const auto ml = _mm512_maskz_loadu_epi8( lanes, row.middle + x - 1 );
+        const auto mc = _mm512_maskz_loadu_epi8( lanes, row.middle + x     );
+        const auto mr = _mm512_maskz_loadu_epi8( lanes, row.middle + x + 1 );
+        const auto ll = _mm512_maskz_loadu_epi8( lanes, row.lower  + x - 1 );
+        const auto lc = _mm512_maskz_loadu_epi8( lanes, row.lower  + x     );
+        const auto lr = _mm512_maskz_loadu_epi8( lanes, row.lower  + x + 1 );
+
+        auto n = __m512i{};
+
+        if constexpr ( topology_von_neumann == Topology_ ) {
+            n = _mm512_add_epi8( _mm512_add_epi8(uc, ml), _mm512_add_epi8(mr, lc) );
+        }
+        else if constexpr ( topology_hexagonal == Topology_ && OddRow_ ) {
+            n = _mm512_add_epi8( _mm512_add_epi8( _mm512_add_epi8(uc, ur), _mm512_add_epi8(ml, mr) ), _mm512_add_epi8(lc, lr) );
+        }
+        else if constexpr ( topology_hexagonal == Topology_ ) {
+            n = _mm512_add_epi8( _mm512_add_epi8( _mm512_add_epi8(ul, uc), _mm512_add_epi8(ml, mr) ), _mm512_add_epi8(ll, lc) );
+        }
+        else {
+            n = _mm512_add_epi8( _mm512_add_epi8( _mm512_add_epi8(ul, uc), _mm512_add_epi8(ur, ml) ),
+                                 _mm512_add_epi8( _mm512_add_epi8(mr, ll), _mm512_add_epi8(lc, lr) ) );
+        }
+
+        const auto born    = _mm512_test_epi8_mask( _mm512_shuffle_epi8(born_lut,    n), one );
+        const auto survive = _mm512_test_epi8_mask( _mm512_shuffle_epi8(survive_lut, n), one );
+
+        // • Transitions
+        //
+        const auto step     = _mm512_maskz_loadu_epi8( lanes, row.step     + x );
+        const auto duration = _mm512_maskz_loadu_epi8( lanes, row.duration + x );
+
+        const auto settled = _mm512_testn_epi8_mask(step, step);
+        const auto alive   = _mm512_test_epi8_mask(mc, mc);
+
+        const auto growth     = settled & ~alive &  born;
+        const auto decline    = settled &  alive & ~survive;
+        const auto transition = growth | decline;
+
+        const auto next_duration = _mm512_mask_blend_epi8( growth, decline_duration, growth_duration );
+
+        // • Results
+        //
+        const auto alive_out    = _mm512_mask_blend_epi8( transition, mc, _mm512_xor_si512(mc, one) );
+        const auto step_out     = _mm512_mask_blend_epi8( transition, _mm512_subs_epu8(step, one), next_duration );
+        const auto duration_out = _mm512_mask_blend_epi8( transition, duration, next_duration );
+
+        _mm512_mask_storeu_epi8( row.next_alive    + x, lanes, alive_out    );
+        _mm512_mask_storeu_epi8( row.next_step     + x, lanes, step_out     );
+        _mm512_mask_storeu_epi8( row.next_duration + x, lanes, duration_out );
+
+        // • Lanes past the row may have grown from no neighbors
+        //
+        if constexpr ( Counted_ )
+        {
+            counts.population    += static_cast<uint32_t>( __builtin_popcountll( (alive ^ transition) & lanes ) );
+            counts.births        += static_cast<uint32_t>( __builtin_popcountll( growth  & lanes ) );
+            counts.deaths        += static_cast<uint32_t>( __builtin_popcountll( decline & lanes ) );
+            counts.transitioning += static_cast<uint32_t>( __builtin_popcountll( _mm512_test_epi8_mask(step_out, step_out) & lanes ) );
+        }
+    }
+
+    if constexpr ( Counted_ ) {
+        add_counts(*row.counts, counts);
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Dispatch
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+template <uint8_t Topology_, bool OddRow_, bool Counted_>
+StepRowKernel isa_kernel(StepKernelISA isa) noexcept
+{
+    switch ( isa )
+    {
+        case StepKernelISA::sse2:   return step_row_sse2<Topology_, OddRow_, Counted_>;
+        case StepKernelISA::avx2:   return step_row_avx2<Topology_, OddRow_, Counted_>;
+        case StepKernelISA::avx512: return step_row_avx512<Topology_, OddRow_, Counted_>;
+
+        default:
+            return nullptr;
+    }
+}
+
+template <uint8_t Topology_, bool OddRow_>
+StepRowKernel topology_kernel(StepKernelISA isa, bool counted) noexcept
+{
+    return counted ? isa_kernel<Topology_, OddRow_, true>(isa) : isa_kernel<Topology_, OddRow_, false>(isa);
+}
+
+} // namespace <anonymous>
+
+StepRowKernel step_row_x86(StepKernelISA isa, uint8_t topology, bool odd_row, bool counted) noexcept
+{
+    switch ( topology )
+    {
+        case topology_von_neumann: return topology_kernel<topology_von_neumann, false>(isa, counted);
+        case topology_hexagonal:   return odd_row ? topology_kernel<topology_hexagonal, true>(isa, counted)
+                                                  : topology_kernel<topology_hexagonal, false>(isa, counted);
+        default:
+            return topology_kernel<topology_moore, false>(isa, counted);
+    }
+}
+
+} // namespace field::detail
+
+#endif // defined ( __x86_64__ ) || defined ( __i386__ )
@@ -0,0 +1,175 @@
+//
+//  StepKernel.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/StepKernel.hpp>
+#include <Shaders/Data/CellRandom.hpp>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+template <uint8_t Topology_, bool OddRow_>
+StepRowKernel scalar_kernel(bool counted) noexcept
+{
+    if ( counted ) {
+        return detail::step_row_scalar<Topology_, OddRow_, true>;
+    }
+
+    return detail::step_row_scalar<Topology_, OddRow_, false>;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Scalar kernel
+//===------------------------------------------------------------------------===
+
+void step_row_scalar(const StepRow& row, uint32_t width, const AutomatRule& rule) noexcept
+{
+    detail::step_row_scalar<topology_moore, false>(row, 0, width, rule);
+}
+
+//===------------------------------------------------------------------------===
+// • Stochastic rules
+//===------------------------------------------------------------------------===
+
+void apply_chances(const StepRow& row, uint32_t width, const AutomatRule& rule, uint32_t x,
+                   uint32_t y, uint32_t field_width, uint64_t generation) noexcept
+{
+    auto fallow   = uint32_t{ 0 };
+    auto declined = uint32_t{ 0 };
+
+    for ( auto i = uint32_t{ 0 }; i < width; ++i, x = ( x + 1u < field_width ) ? x + 1u : 0u )
+    {
+        if ( 0 != row.step[i] || 0 == row.next_alive[i] ) {
+            continue;
+        }
+
+        if ( 0 == row.middle[i] )
+        {
+            // • Growth
+            //
+            if ( 0 != rule.born_chance && !passes_chance(rule.born_chance, cell_random(rule.seed, generation, x, y)) )
+            {
+                row.next_alive[i]    = 0;
+                row.next_step[i]     = 0;
+                row.next_duration[i] = row.duration[i];
+
+                ++fallow;
+            }
+        }
+        else if ( 0 != rule.survive_chance && !passes_chance(rule.survive_chance, cell_random(rule.seed, generation, x, y)) )
+        {
+            // • Decline
+            //
+            row.next_alive[i]    = 0;
+            row.next_step[i]     = rule.decline_duration;
+            row.next_duration[i] = rule.decline_duration;
+
+            ++declined;
+        }
+    }
+
+    // • A fallow cell is no birth and no longer stepping, and a declined one
+    //      is a death that may be
+    //
+    if ( nullptr != row.counts )
+    {
+        row.counts->population    -= fallow + declined;
+        row.counts->births        -= fallow;
+        row.counts->deaths        += declined;
+        row.counts->transitioning += ( 0 != rule.decline_duration ) ? declined : 0u;
+        row.counts->transitioning -= ( 0 != rule.growth_duration )  ? fallow   : 0u;
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Dispatch
+//===------------------------------------------------------------------------===
+
+StepKernelISA best_step_kernel_isa(void) noexcept
+{
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+
+    static const auto isa = []
+    {
+        __builtin_cpu_init();
+
+        if ( __builtin_cpu_supports("avx512bw") ) {
+            return StepKernelISA::avx512;
+        }
+        else if ( __builtin_cpu_supports("avx2") ) {
+            return StepKernelISA::avx2;
+        }
+        else if ( __builtin_cpu_supports("sse2") ) {
+            return StepKernelISA::sse2;
+        }
+
+        return StepKernelISA::scalar;
+    }();
+
+    return isa;
+
+#else
+
+    return StepKernelISA::scalar;
+
+#endif
+}
+
+StepRowKernel step_row_kernel(StepKernelISA isa, uint8_t topology, bool odd_row, bool counted) noexcept
+{
+    if ( static_cast<uint32_t>(best_step_kernel_isa()) < static_cast<uint32_t>(isa) ) {
+        return nullptr;
+    }
+
+    if ( StepKernelISA::scalar != isa )
+    {
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+
+        return detail::step_row_x86(isa, topology, odd_row, counted);
+
+#else
+
+        return nullptr;
+
+#endif
+    }
+
+    switch ( topology )
+    {
+        case topology_von_neumann: return scalar_kernel<topology_von_neumann, false>(counted);
+        case topology_hexagonal:   return odd_row ? scalar_kernel<topology_hexagonal, true>(counted)
+                                                  : scalar_kernel<topology_hexagonal, false>(counted);
+        default:
+            return counted ? scalar_kernel<topology_moore, false>(true) : step_row_scalar;
+    }
+}
+
+} // namespace field
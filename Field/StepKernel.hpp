@@ -0,0 +1,202 @@
+//
+//  StepKernel.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Shaders/Data/AutomatRule.hpp>
+#include <Shaders/Data/Neighborhood.hpp>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • StepCounts
+//
+//  Cells of a stepped row: alive after the step, those that became alive or
+//  dead in it, and those still stepping
+//===------------------------------------------------------------------------===
+
+struct StepCounts
+{
+    uint32_t    population;
+    uint32_t    births;
+    uint32_t    deaths;
+    uint32_t    transitioning;
+};
+
+constexpr void add_counts(StepCounts& counts, const StepCounts& more) noexcept
+{
+    counts.population    += more.population;
+    counts.births        += more.births;
+    counts.deaths        += more.deaths;
+    counts.transitioning += more.transitioning;
+}
+
+//===------------------------------------------------------------------------===
+//
+// • StepRow
+//
+//  One row of byte planes (alive, step, duration) to step. Alive values are
+//  0 or 1 and the three alive rows must be readable from [-1] to [width], so
+//  the kernels never wrap coordinates themselves. Counted kernels add the
+//  row's counts to counts, which the others ignore.
+//
+//===------------------------------------------------------------------------===
+
+struct StepRow
+{
+    const uint8_t*  upper;
+    const uint8_t*  middle;
+    const uint8_t*  lower;
+    const uint8_t*  step;
+    const uint8_t*  duration;
+
+    uint8_t*        next_alive;
+    uint8_t*        next_step;
+    uint8_t*        next_duration;
+
+    StepCounts*     counts;
+};
+
+using StepRowKernel = void (*)(const StepRow& row, uint32_t width, const AutomatRule& rule) noexcept;
+
+//===------------------------------------------------------------------------===
+// • Instruction sets
+//===------------------------------------------------------------------------===
+
+enum class StepKernelISA : uint32_t
+{
+    scalar,     //  1 cell per iteration
+    sse2,       // 16 cells per instruction
+    avx2,       // 32 cells per instruction
+    avx512,     // 64 cells per instruction (AVX-512BW)
+};
+
+//===------------------------------------------------------------------------===
+// • Kernels
+//===------------------------------------------------------------------------===
+
+// • Moore neighborhood
+//
+void step_row_scalar(const StepRow& row, uint32_t width, const AutomatRule& rule) noexcept;
+
+// • Kernel for a specific instruction set and for the rows of a topology
+//      with the given parity (which differ only on the hexagonal grid), or
+//      nullptr when it is not built for this architecture or not supported
+//      by the running processor. A counted kernel also counts each row from
+//      the masks it builds, and is only chosen when the counts are wanted.
+//
+StepRowKernel step_row_kernel(StepKernelISA isa, uint8_t topology = topology_moore, bool odd_row = false,
+                              bool counted = false) noexcept;
+
+// • Widest instruction set supported by the running processor, determined
+//      once from CPUID
+//
+StepKernelISA best_step_kernel_isa(void) noexcept;
+
+inline StepRowKernel step_row_kernel(void) noexcept
+{
+    return step_row_kernel( best_step_kernel_isa() );
+}
+
+//===------------------------------------------------------------------------===
+// • Stochastic rules
+//
+//  Applied to a row after any kernel has stepped it with the rule's masks:
+//  a settled cell that grew is left fallow unless its draw passes the born
+//  chance, and one that stayed alive declines unless its draw passes the
+//  survive chance. Draws are made only for those cells. The first cell is
+//  at field column x of row y, and columns wrap at field_width. The row's
+//  counts, when it has them, are corrected for the changed cells.
+//===------------------------------------------------------------------------===
+
+void apply_chances(const StepRow& row, uint32_t width, const AutomatRule& rule, uint32_t x,
+                   uint32_t y, uint32_t field_width, uint64_t generation) noexcept;
+
+namespace detail
+{
+
+//===------------------------------------------------------------------------===
+// • Scalar kernel
+//
+//  Same branch-free formulation as the vector kernels: a cell still stepping
+//  counts down (saturating at zero), a settled cell may start a transition.
+//  Also the remainder of the vector kernels, so it is defined here for every
+//  topology they instantiate.
+//===------------------------------------------------------------------------===
+
+template <uint8_t Topology_, bool OddRow_, bool Counted_ = false>
+void step_row_scalar(const StepRow& row, uint32_t begin, uint32_t end, const AutomatRule& rule) noexcept
+{
+    auto counts = StepCounts{};
+
+    for ( auto x = begin; x < end; ++x )
+    {
+        const auto neighbor_count = Neighborhood<Topology_, OddRow_>::count( row.upper + x, row.middle + x, row.lower + x );
+
+        const auto neighbors = 1u << neighbor_count;
+        const auto alive     = row.middle[x];
+        const auto step      = row.step[x];
+        const auto settled   = (0 == step);
+
+        const auto growth  = settled && !alive && 0 != (neighbors & rule.born);
+        const auto decline = settled &&  alive && 0 == (neighbors & rule.survive);
+
+        const auto duration = growth ? rule.growth_duration : rule.decline_duration;
+
+        row.next_alive[x]    = static_cast<uint8_t>( alive ^ (growth | decline) );
+        row.next_step[x]     = (growth | decline) ? duration : static_cast<uint8_t>( step - !settled );
+        row.next_duration[x] = (growth | decline) ? duration : row.duration[x];
+
+        if constexpr ( Counted_ )
+        {
+            counts.population    += row.next_alive[x];
+            counts.births        += growth;
+            counts.deaths        += decline;
+            counts.transitioning += ( 0 != row.next_step[x] );
+        }
+    }
+
+    if constexpr ( Counted_ ) {
+        add_counts(*row.counts, counts);
+    }
+}
+
+template <uint8_t Topology_, bool OddRow_, bool Counted_ = false>
+void step_row_scalar(const StepRow& row, uint32_t width, const AutomatRule& rule) noexcept
+{
+    step_row_scalar<Topology_, OddRow_, Counted_>(row, 0, width, rule);
+}
+
+#if defined ( __x86_64__ ) || defined ( __i386__ )
+
+// • Vector kernel for an instruction set other than scalar and a topology
+//      row, or nullptr
+//
+StepRowKernel step_row_x86(StepKernelISA isa, uint8_t topology, bool odd_row, bool counted) noexcept;
+
+#endif
+
+} // namespace detail
+
+} // namespace field
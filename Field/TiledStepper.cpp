@@ -0,0 +1,918 @@
+//
+//  TiledStepper.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/TiledStepper.hpp>
+#include <Field/RuleKernel.hpp>
+#include <Field/Step.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+// • Rows are padded to whole cache lines, plus one more line when the stride
+//      would otherwise be a multiple of 1 KiB: a tile reads 34 rows of each
+//      plane at the same column, which would all map to the same few cache sets
+//
+constexpr uint32_t padded_stride(uint32_t width) noexcept
+{
+    const auto stride = (width + 63u) & ~63u;
+
+    return ( 0 == stride % 1024u ) ? stride + 64u : stride;
+}
+
+constexpr uint32_t wrap(int64_t value, uint32_t count) noexcept
+{
+    return static_cast<uint32_t>( (value % count + count) % count );
+}
+
+// • Sets each flag along lines of count flags (element step apart, lines
+//      line_step apart) if any flag within radius of it is set, wrapping
+//
+void dilate(const uint8_t* source, uint8_t* dest, uint32_t count, uint32_t lines,
+            uint32_t step, uint32_t line_step, uint32_t radius) noexcept
+{
+    for ( auto line = uint32_t{ 0 }; line < lines; ++line )
+    {
+        const auto src = source + size_t{ line } * line_step;
+        auto       dst = dest   + size_t{ line } * line_step;
+
+        if ( count <= 2u * radius + 1u )
+        {
+            auto any = uint8_t{ 0 };
+
+            for ( auto i = uint32_t{ 0 }; i < count; ++i ) {
+                any |= src[i * step];
+            }
+            for ( auto i = uint32_t{ 0 }; i < count; ++i ) {
+                dst[i * step] = any;
+            }
+
+            continue;
+        }
+
+        for ( auto i = uint32_t{ 0 }; i < count; ++i )
+        {
+            auto any = src[i * step];
+
+            for ( auto offset = uint32_t{ 1 }; offset <= radius; ++offset )
+            {
+                const auto before = ( offset <= i )        ? i - offset : i + count - offset;
+                const auto after  = ( i + offset < count ) ? i + offset : i + offset - count;
+
+                any |= src[before * step] | src[after * step];
+            }
+
+            dst[i * step] = any;
+        }
+    }
+}
+
+// • Counts a stepped row of count cells: alive before, and alive and step
+//      after, for the few cells that no kernel counts
+//
+void count_row(StepCounts& counts, const uint8_t* alive, const uint8_t* next_alive,
+               const uint8_t* next_step, uint32_t count) noexcept
+{
+    for ( auto x = uint32_t{ 0 }; x < count; ++x )
+    {
+        const auto before = uint32_t{ alive[x] };
+        const auto after  = uint32_t{ next_alive[x] };
+
+        counts.population    += after;
+        counts.births        += after & (before ^ 1u);
+        counts.deaths        += before & (after ^ 1u);
+        counts.transitioning += ( 0 != next_step[x] ) ? 1u : 0u;
+    }
+}
+
+// • Adds counts, less those of cells outside the stats' region
+//
+void add_stats(StepStats& stats, const StepCounts& counts, const StepCounts& outside = {}) noexcept
+{
+    stats.population    += counts.population    - outside.population;
+    stats.births        += counts.births        - outside.births;
+    stats.deaths        += counts.deaths        - outside.deaths;
+    stats.transitioning += counts.transitioning - outside.transitioning;
+}
+
+// • The row from its cell at offset, counted into counts
+//
+StepRow row_at(const StepRow& row, uint32_t offset, StepCounts* counts) noexcept
+{
+    return {
+        .upper         = row.upper         + offset,
+        .middle        = row.middle        + offset,
+        .lower         = row.lower         + offset,
+        .step          = row.step          + offset,
+        .duration      = row.duration      + offset,
+        .next_alive    = row.next_alive    + offset,
+        .next_step     = row.next_step     + offset,
+        .next_duration = row.next_duration + offset,
+        .counts        = counts
+    };
+}
+
+constexpr bool is_active(const StepStats& stats) noexcept
+{
+    return 0 != stats.population || 0 != stats.transitioning;
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+TiledStepper::TiledStepper(uint32_t width, uint32_t height, uint32_t worker_count) noexcept(false)
+    :
+        m_width      { width  },
+        m_height     { height },
+        m_stride     { padded_stride(width) },
+        m_current    { 0      },
+        m_generation { 0      },
+        m_tiles_wide { (width  + tile_size - 1u) / tile_size },
+        m_tiles_high { (height + tile_size - 1u) / tile_size },
+        m_blocks_wide{ (width  + block_size - 1u) / block_size },
+        m_blocks_high{ (height + block_size - 1u) / block_size },
+        m_kernel            { nullptr },
+        m_odd_kernel        { nullptr },
+        m_counted_kernel    { nullptr },
+        m_counted_odd_kernel{ nullptr },
+        m_pool              { worker_count },
+        m_stats_enabled     { false }
+{
+    if ( 0 == width || 0 == height ) {
+        throw false;
+    }
+
+    const auto plane_size = size_t{ m_stride } * height;
+
+    for ( auto& planes : m_planes )
+    {
+        planes.alive.assign   ( plane_size, 0 );
+        planes.step.assign    ( plane_size, 0 );
+        planes.duration.assign( plane_size, 0 );
+    }
+
+    m_scratch.resize( m_pool.worker_count() );
+    m_block_scratch.resize( m_pool.worker_count() );
+
+    m_tile_active.assign( m_tiles_wide * m_tiles_high, 0 );
+    m_tile_synced.assign( m_tiles_wide * m_tiles_high, 1 );
+
+    m_tile_stats.assign( m_tiles_wide * m_tiles_high, StepStats{} );
+    m_block_stats.assign( size_t{ m_blocks_wide } * m_blocks_high * max_depth, StepStats{} );
+    m_generation_stats.assign( 1, StepStats{} );
+}
+
+//===------------------------------------------------------------------------===
+// • Accessors
+//===------------------------------------------------------------------------===
+
+FieldValue TiledStepper::value(uint32_t x, uint32_t y) const noexcept
+{
+    assert( x < m_width && y < m_height );
+
+    const auto& planes = m_planes[m_current];
+    const auto  index  = size_t{ y } * m_stride + x;
+
+    return {
+        .alive    = planes.alive[index],
+        .step     = planes.step[index],
+        .duration = planes.duration[index],
+        .reserved = 0
+    };
+}
+
+uint32_t TiledStepper::active_tile_count(void) const noexcept
+{
+    return static_cast<uint32_t>( std::count( m_tile_active.begin(), m_tile_active.end(), 1 ) );
+}
+
+//===------------------------------------------------------------------------===
+// • Transfer
+//===------------------------------------------------------------------------===
+
+void TiledStepper::load(const Grid& grid, uint64_t generation) noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    auto& planes = m_planes[m_current];
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto src      = grid.row(y);
+        const auto offset   = size_t{ y } * m_stride;
+        auto       alive    = planes.alive.data()    + offset;
+        auto       step     = planes.step.data()     + offset;
+        auto       duration = planes.duration.data() + offset;
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            alive[x]    = ( 0 != src[x].alive ) ? 1 : 0;
+            step[x]     = src[x].step;
+            duration[x] = src[x].duration;
+        }
+    }
+
+    m_generation = generation;
+
+    update_activity();
+}
+
+void TiledStepper::store(Grid& grid) const noexcept(false)
+{
+    if ( grid.width() != m_width || grid.height() != m_height ) {
+        throw false;
+    }
+
+    const auto& planes = m_planes[m_current];
+
+    for ( auto y = uint32_t{ 0 }; y < m_height; ++y )
+    {
+        const auto offset   = size_t{ y } * m_stride;
+        const auto alive    = planes.alive.data()    + offset;
+        const auto step     = planes.step.data()     + offset;
+        const auto duration = planes.duration.data() + offset;
+
+        auto dest = grid.row(y);
+
+        for ( auto x = uint32_t{ 0 }; x < m_width; ++x )
+        {
+            dest[x] = { alive[x], step[x], duration[x], 0 };
+        }
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Stats
+//===------------------------------------------------------------------------===
+
+void TiledStepper::set_stats_enabled(bool enabled) noexcept
+{
+    if ( enabled == m_stats_enabled ) {
+        return;
+    }
+
+    m_stats_enabled = enabled;
+
+    std::fill( m_tile_stats.begin(), m_tile_stats.end(), StepStats{} );
+    m_generation_stats.assign( 1, StepStats{} );
+
+    if ( enabled ) {
+        update_activity();
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Step
+//===------------------------------------------------------------------------===
+
+void TiledStepper::step(const AutomatRule& rule) noexcept
+{
+    if ( m_stats_enabled ) {
+        m_generation_stats.clear();
+    }
+
+    step_generation(rule);
+}
+
+void TiledStepper::step_generation(const AutomatRule& rule) noexcept
+{
+    assert( !is_larger_than_life(rule) && is_torus(rule) );
+
+    const auto can_skip = !is_born(rule, 0);
+
+    dilate_activity(1, 1);
+
+    m_work.clear();
+    m_copies.clear();
+
+    for ( auto tile = uint32_t{ 0 }; tile < m_tiles_wide * m_tiles_high; ++tile )
+    {
+        if ( !can_skip || 0 != m_tile_needed[tile] )
+        {
+            m_work.push_back(tile);
+            m_tile_synced[tile] = 0;
+        }
+        else
+        {
+            // • A skipped tile is inactive, and so stays empty
+            //
+            m_tile_stats[tile] = StepStats{};
+
+            if ( 0 == m_tile_synced[tile] )
+            {
+                m_copies.push_back(tile);
+                m_tile_synced[tile] = 1;
+            }
+        }
+    }
+
+    run_work(1, rule);
+    sum_stats(1);
+}
+
+void TiledStepper::run_work(uint32_t depth, const AutomatRule& rule) noexcept
+{
+    m_kernel     = step_row_kernel(rule);
+    m_odd_kernel = step_row_kernel(rule, true);
+
+    if ( m_stats_enabled )
+    {
+        m_counted_kernel     = step_row_kernel(rule, false, true);
+        m_counted_odd_kernel = step_row_kernel(rule, true,  true);
+    }
+
+    const auto work_count = static_cast<uint32_t>( m_work.size() );
+    const auto task_count = static_cast<uint32_t>( m_work.size() + m_copies.size() );
+
+    m_pool.run( task_count, [&](uint32_t worker, uint32_t task)
+    {
+        if ( work_count <= task ) {
+            copy_tile( m_copies[task - work_count] );
+        }
+        else if ( 1 == depth ) {
+            step_tile( m_work[task], m_scratch[worker], rule );
+        }
+        else {
+            step_block( m_work[task], depth, m_block_scratch[worker], rule );
+        }
+    });
+
+    m_current    ^= 1u;
+    m_generation += depth;
+}
+
+void TiledStepper::sum_stats(uint32_t depth) noexcept
+{
+    if ( !m_stats_enabled ) {
+        return;
+    }
+
+    // • Earlier generations of a pass from the blocks, the last from the
+    //      tiles, in order
+    //
+    const auto block_count = m_blocks_wide * m_blocks_high;
+
+    for ( auto generation = uint32_t{ 0 }; generation + 1u < depth; ++generation )
+    {
+        auto total = StepStats{};
+
+        for ( auto block = uint32_t{ 0 }; block < block_count; ++block )
+        {
+            const auto& stats = m_block_stats[size_t{ block } * max_depth + generation];
+
+            total.population    += stats.population;
+            total.births        += stats.births;
+            total.deaths        += stats.deaths;
+            total.transitioning += stats.transitioning;
+        }
+
+        m_generation_stats.push_back(total);
+    }
+
+    auto total = StepStats{};
+
+    for ( const auto& stats : m_tile_stats )
+    {
+        total.population    += stats.population;
+        total.births        += stats.births;
+        total.deaths        += stats.deaths;
+        total.transitioning += stats.transitioning;
+    }
+
+    m_generation_stats.push_back(total);
+}
+
+void TiledStepper::copy_tile(uint32_t tile) noexcept
+{
+    const auto& source = m_planes[m_current];
+    auto&       dest   = m_planes[m_current ^ 1u];
+
+    const auto left        = (tile % m_tiles_wide) * tile_size;
+    const auto top         = (tile / m_tiles_wide) * tile_size;
+    const auto tile_width  = std::min<uint32_t>( tile_size, m_width  - left );
+    const auto tile_height = std::min<uint32_t>( tile_size, m_height - top  );
+
+    for ( auto r = uint32_t{ 0 }; r < tile_height; ++r )
+    {
+        const auto offset = size_t{ top + r } * m_stride + left;
+
+        std::memcpy( dest.alive.data()    + offset, source.alive.data()    + offset, tile_width );
+        std::memcpy( dest.step.data()     + offset, source.step.data()     + offset, tile_width );
+        std::memcpy( dest.duration.data() + offset, source.duration.data() + offset, tile_width );
+    }
+}
+
+void TiledStepper::step_tile(uint32_t tile, Scratch& scratch, const AutomatRule& rule) noexcept
+{
+    const auto& source = m_planes[m_current];
+    auto&       dest   = m_planes[m_current ^ 1u];
+
+    const auto left        = (tile % m_tiles_wide) * tile_size;
+    const auto top         = (tile / m_tiles_wide) * tile_size;
+    const auto tile_width  = std::min<uint32_t>( tile_size, m_width  - left );
+    const auto tile_height = std::min<uint32_t>( tile_size, m_height - top  );
+
+    const auto stride = tile_width + 2u;
+    const auto west_x = (left + m_width - 1u) % m_width;
+    const auto east_x = (left + tile_width) % m_width;
+
+    // • Copy the alive cells of the tile and its one cell border to scratch
+    //
+    for ( auto r = uint32_t{ 0 }; r < tile_height + 2u; ++r )
+    {
+        const auto src   = source.alive.data() + size_t{ (top + r + m_height - 1u) % m_height } * m_stride;
+        const auto alive = scratch.alive + r * stride;
+
+        alive[0] = src[west_x];
+        std::memcpy( alive + 1u, src + left, tile_width );
+        alive[tile_width + 1u] = src[east_x];
+    }
+
+    // • Step rows from scratch directly into the destination planes, counted
+    //      by the kernels when stats are enabled
+    //
+    auto counts = StepCounts{};
+
+    for ( auto r = uint32_t{ 0 }; r < tile_height; ++r )
+    {
+        const auto offset = size_t{ top + r } * m_stride + left;
+
+        const auto row = StepRow {
+            .upper         = scratch.alive + (r + 0u) * stride + 1u,
+            .middle        = scratch.alive + (r + 1u) * stride + 1u,
+            .lower         = scratch.alive + (r + 2u) * stride + 1u,
+            .step          = source.step.data()     + offset,
+            .duration      = source.duration.data() + offset,
+            .next_alive    = dest.alive.data()      + offset,
+            .next_step     = dest.step.data()       + offset,
+            .next_duration = dest.duration.data()   + offset,
+            .counts        = m_stats_enabled ? &counts : nullptr
+        };
+
+        const auto odd    = 0 != ( (top + r) & 1u );
+        const auto kernel = m_stats_enabled ? ( odd ? m_counted_odd_kernel : m_counted_kernel )
+                                            : ( odd ? m_odd_kernel : m_kernel );
+
+        kernel(row, tile_width, rule);
+
+        if ( is_stochastic(rule) ) {
+            apply_chances( row, tile_width, rule, left, top + r, m_width, m_generation );
+        }
+    }
+
+    if ( m_stats_enabled )
+    {
+        m_tile_stats[tile] = StepStats{};
+        add_stats( m_tile_stats[tile], counts );
+
+        m_tile_active[tile] = is_active(m_tile_stats[tile]) ? 1 : 0;
+    }
+    else
+    {
+        m_tile_active[tile] = is_tile_live(dest, tile) ? 1 : 0;
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Temporal blocking
+//===------------------------------------------------------------------------===
+
+void TiledStepper::step(const AutomatRule& rule, uint32_t generations, uint32_t depth) noexcept
+{
+    static_assert( max_depth <= tile_size && 0 == block_size % tile_size );
+
+    assert( !is_larger_than_life(rule) && is_torus(rule) );
+
+    const auto can_skip   = !is_born(rule, 0);
+    const auto block_span = block_size / tile_size;
+
+    // • Changes spread at most one cell per generation, so a ring of tiles
+    //      around a block covers a pass, unless the ring is a narrow edge tile
+    //
+    const auto ring_x = ( 0 == m_width  % tile_size ) ? 1u : 2u;
+    const auto ring_y = ( 0 == m_height % tile_size ) ? 1u : 2u;
+
+    depth = std::clamp<uint32_t>( depth, 1u, max_depth );
+
+    if ( m_stats_enabled ) {
+        m_generation_stats.clear();
+    }
+
+    while ( 0 < generations )
+    {
+        const auto pass_depth = std::min(generations, depth);
+
+        generations -= pass_depth;
+
+        if ( 1 == pass_depth )
+        {
+            step_generation(rule);
+            continue;
+        }
+
+        dilate_activity(ring_x, ring_y);
+
+        m_work.clear();
+        m_copies.clear();
+
+        for ( auto block_y = uint32_t{ 0 }; block_y < m_blocks_high; ++block_y )
+        {
+            for ( auto block_x = uint32_t{ 0 }; block_x < m_blocks_wide; ++block_x )
+            {
+                const auto first_x = block_x * block_span;
+                const auto first_y = block_y * block_span;
+                const auto last_x  = std::min(first_x + block_span, m_tiles_wide) - 1u;
+                const auto last_y  = std::min(first_y + block_span, m_tiles_high) - 1u;
+
+                auto compute = !can_skip;
+
+                for ( auto tile_y = first_y; tile_y <= last_y; ++tile_y )
+                {
+                    for ( auto tile_x = first_x; tile_x <= last_x; ++tile_x )
+                    {
+                        compute |= ( 0 != m_tile_needed[tile_y * m_tiles_wide + tile_x] );
+                    }
+                }
+
+                const auto block = block_y * m_blocks_wide + block_x;
+
+                if ( compute ) {
+                    m_work.push_back(block);
+                }
+                else {
+                    std::fill_n( m_block_stats.begin() + size_t{ block } * max_depth, pass_depth - 1u, StepStats{} );
+                }
+
+                for ( auto tile_y = first_y; tile_y <= last_y; ++tile_y )
+                {
+                    for ( auto tile_x = first_x; tile_x <= last_x; ++tile_x )
+                    {
+                        const auto tile = tile_y * m_tiles_wide + tile_x;
+
+                        if ( compute )
+                        {
+                            m_tile_synced[tile] = 0;
+                            continue;
+                        }
+
+                        m_tile_stats[tile] = StepStats{};
+
+                        if ( 0 == m_tile_synced[tile] )
+                        {
+                            m_copies.push_back(tile);
+                            m_tile_synced[tile] = 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        run_work(pass_depth, rule);
+        sum_stats(pass_depth);
+    }
+}
+
+void TiledStepper::read_span(const std::vector<uint8_t>& plane, int64_t left, int64_t top,
+                             uint32_t span_width, uint32_t span_height, uint8_t* dest) const noexcept
+{
+    // • The span may wrap (more than once, for a halo wider than the field)
+    //
+    const auto first_x = wrap(left, m_width);
+    const auto first_y = wrap(top,  m_height);
+
+    auto y = first_y;
+
+    for ( auto r = uint32_t{ 0 }; r < span_height; ++r )
+    {
+        const auto src = plane.data() + size_t{ y } * m_stride;
+
+        auto x = first_x;
+
+        for ( auto c = uint32_t{ 0 }; c < span_width; )
+        {
+            const auto count = std::min(span_width - c, m_width - x);
+
+            std::memcpy( dest + c, src + x, count );
+
+            c += count;
+            x  = 0;
+        }
+
+        dest += span_width;
+        y     = ( y + 1u < m_height ) ? y + 1u : 0u;
+    }
+}
+
+void TiledStepper::step_block(uint32_t block, uint32_t depth, BlockScratch& scratch, const AutomatRule& rule) noexcept
+{
+    const auto& source = m_planes[m_current];
+    auto&       dest   = m_planes[m_current ^ 1u];
+
+    const auto left         = (block % m_blocks_wide) * block_size;
+    const auto top          = (block / m_blocks_wide) * block_size;
+    const auto block_width  = std::min<uint32_t>( block_size, m_width  - left );
+    const auto block_height = std::min<uint32_t>( block_size, m_height - top  );
+
+    const auto span_width  = block_width  + 2u * depth;
+    const auto span_height = block_height + 2u * depth;
+    const auto span_size   = size_t{ span_width } * span_height;
+
+    for ( auto index = 0u; index < 2u; ++index )
+    {
+        scratch.alive[index].resize(span_size);
+        scratch.step[index].resize(span_size);
+        scratch.duration[index].resize(span_size);
+    }
+
+    // • Read the block with a halo of depth cells
+    //
+    const auto span_left = int64_t{ left } - depth;
+    const auto span_top  = int64_t{ top  } - depth;
+
+    read_span( source.alive,    span_left, span_top, span_width, span_height, scratch.alive[0].data()    );
+    read_span( source.step,     span_left, span_top, span_width, span_height, scratch.step[0].data()     );
+    read_span( source.duration, span_left, span_top, span_width, span_height, scratch.duration[0].data() );
+
+    // • Tiles of the block, counted in the last generation
+    //
+    const auto block_span = block_size / tile_size;
+    const auto first_x    = (block % m_blocks_wide) * block_span;
+    const auto first_y    = (block / m_blocks_wide) * block_span;
+    const auto last_x     = std::min(first_x + block_span, m_tiles_wide);
+    const auto last_y     = std::min(first_y + block_span, m_tiles_high);
+
+    const auto block_stats = m_block_stats.begin() + size_t{ block } * max_depth;
+
+    if ( m_stats_enabled )
+    {
+        for ( auto tile_y = first_y; tile_y < last_y; ++tile_y )
+        {
+            std::fill( m_tile_stats.begin() + tile_y * m_tiles_wide + first_x,
+                       m_tile_stats.begin() + tile_y * m_tiles_wide + last_x, StepStats{} );
+        }
+
+        std::fill_n( block_stats, depth - 1u, StepStats{} );
+    }
+
+    // • Each generation is valid one cell further inside the span than the
+    //      last, and reads only cells that were valid in the last. Rows of
+    //      the block interior are counted by the kernels when stats are
+    //      enabled, the last generation's a tile at a time
+    //
+    auto current = 0u;
+
+    for ( auto generation = uint32_t{ 1 }; generation <= depth; ++generation )
+    {
+        const auto next      = current ^ 1u;
+        const auto row_width = span_width - 2u * generation;
+        const auto alive     = scratch.alive[current].data();
+
+        for ( auto r = generation; r < span_height - generation; ++r )
+        {
+            const auto offset = size_t{ r } * span_width + generation;
+
+            const auto row = StepRow {
+                .upper         = alive + offset - span_width,
+                .middle        = alive + offset,
+                .lower         = alive + offset + span_width,
+                .step          = scratch.step[current].data()     + offset,
+                .duration      = scratch.duration[current].data() + offset,
+                .next_alive    = scratch.alive[next].data()       + offset,
+                .next_step     = scratch.step[next].data()        + offset,
+                .next_duration = scratch.duration[next].data()    + offset,
+                .counts        = nullptr
+            };
+
+            const auto y          = wrap(span_top + r, m_height);
+            const auto x          = wrap(span_left + generation, m_width);
+            const auto row_gen    = m_generation + generation - 1u;
+            const auto odd        = 0 != ( y & 1u );
+            const auto stochastic = is_stochastic(rule);
+
+            if ( !m_stats_enabled || r < depth || depth + block_height <= r )
+            {
+                ( odd ? m_odd_kernel : m_kernel )(row, row_width, rule);
+
+                if ( stochastic ) {
+                    apply_chances( row, row_width, rule, x, y, m_width, row_gen );
+                }
+
+                continue;
+            }
+
+            const auto kernel = odd ? m_counted_odd_kernel : m_counted_kernel;
+            const auto inset  = depth - generation;
+
+            if ( generation < depth )
+            {
+                // • The kernel counts the whole row; the halo cells on either
+                //      side of the block are then taken back out
+                //
+                auto counts  = StepCounts{};
+                auto outside = StepCounts{};
+
+                const auto counted = row_at(row, 0, &counts);
+
+                kernel(counted, row_width, rule);
+
+                if ( stochastic ) {
+                    apply_chances( counted, row_width, rule, x, y, m_width, row_gen );
+                }
+
+                const auto east = inset + block_width;
+
+                count_row( outside, row.middle, row.next_alive, row.next_step, inset );
+                count_row( outside, row.middle + east, row.next_alive + east, row.next_step + east, row_width - east );
+
+                add_stats( block_stats[generation - 1u], counts, outside );
+                continue;
+            }
+
+            auto tile = ( first_y + (r - depth) / tile_size ) * m_tiles_wide + first_x;
+
+            for ( auto c = uint32_t{ 0 }; c < block_width; c += tile_size, ++tile )
+            {
+                const auto count   = std::min<uint32_t>( tile_size, block_width - c );
+                auto       counts  = StepCounts{};
+                const auto counted = row_at(row, c, &counts);
+
+                kernel(counted, count, rule);
+
+                if ( stochastic ) {
+                    apply_chances( counted, count, rule, wrap(int64_t{ x } + c, m_width), y, m_width, row_gen );
+                }
+
+                add_stats( m_tile_stats[tile], counts );
+            }
+        }
+
+        current = next;
+    }
+
+    // • Write the block interior back
+    //
+    for ( auto r = uint32_t{ 0 }; r < block_height; ++r )
+    {
+        const auto from = size_t{ r + depth } * span_width + depth;
+        const auto to   = size_t{ top + r } * m_stride + left;
+
+        std::memcpy( dest.alive.data()    + to, scratch.alive[current].data()    + from, block_width );
+        std::memcpy( dest.step.data()     + to, scratch.step[current].data()     + from, block_width );
+        std::memcpy( dest.duration.data() + to, scratch.duration[current].data() + from, block_width );
+    }
+
+    // • Activity of the tiles in the block
+    //
+    for ( auto tile_y = first_y; tile_y < last_y; ++tile_y )
+    {
+        for ( auto tile_x = first_x; tile_x < last_x; ++tile_x )
+        {
+            const auto tile = tile_y * m_tiles_wide + tile_x;
+
+            m_tile_active[tile] = m_stats_enabled ? ( is_active(m_tile_stats[tile]) ? 1 : 0 )
+                                                  : ( is_tile_live(dest, tile) ? 1 : 0 );
+        }
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Activity
+//===------------------------------------------------------------------------===
+
+StepStats TiledStepper::scan_tile(const Planes& planes, uint32_t tile) const noexcept
+{
+    const auto left        = (tile % m_tiles_wide) * tile_size;
+    const auto top         = (tile / m_tiles_wide) * tile_size;
+    const auto tile_width  = std::min<uint32_t>( tile_size, m_width  - left );
+    const auto tile_height = std::min<uint32_t>( tile_size, m_height - top  );
+
+    auto counts = StepCounts{};
+
+    for ( auto r = uint32_t{ 0 }; r < tile_height; ++r )
+    {
+        const auto offset = size_t{ top + r } * m_stride + left;
+
+        // • Counted as a step from the same cells: no births or deaths
+        //
+        count_row( counts, planes.alive.data() + offset, planes.alive.data() + offset,
+                   planes.step.data() + offset, tile_width );
+    }
+
+    auto stats = StepStats{};
+    add_stats( stats, counts );
+
+    return stats;
+}
+
+bool TiledStepper::is_tile_live(const Planes& planes, uint32_t tile) const noexcept
+{
+    const auto left        = (tile % m_tiles_wide) * tile_size;
+    const auto top         = (tile / m_tiles_wide) * tile_size;
+    const auto tile_width  = std::min<uint32_t>( tile_size, m_width  - left );
+    const auto tile_height = std::min<uint32_t>( tile_size, m_height - top  );
+
+    auto any = uint64_t{ 0 };
+
+    for ( auto r = uint32_t{ 0 }; r < tile_height; ++r )
+    {
+        const auto offset = size_t{ top + r } * m_stride + left;
+        const auto alive  = planes.alive.data() + offset;
+        const auto step   = planes.step.data()  + offset;
+
+        // • Eight cells at a time, then the rest
+        //
+        auto c = uint32_t{ 0 };
+
+        for ( ; c + 8u <= tile_width; c += 8u )
+        {
+            auto alive_word = uint64_t{ 0 };
+            auto step_word  = uint64_t{ 0 };
+
+            std::memcpy( &alive_word, alive + c, 8 );
+            std::memcpy( &step_word,  step  + c, 8 );
+
+            any |= alive_word | step_word;
+        }
+
+        for ( ; c < tile_width; ++c ) {
+            any |= alive[c] | step[c];
+        }
+    }
+
+    return 0 != any;
+}
+
+void TiledStepper::dilate_activity(uint32_t ring_x, uint32_t ring_y) noexcept
+{
+    // • Separable toroidal dilation: rows into m_tile_dilated, then its
+    //      columns into m_tile_needed
+    //
+    m_tile_needed.resize( m_tile_active.size() );
+    m_tile_dilated.resize( m_tile_active.size() );
+
+    dilate( m_tile_active.data(), m_tile_dilated.data(), m_tiles_wide, m_tiles_high, 1, m_tiles_wide, ring_x );
+    dilate( m_tile_dilated.data(), m_tile_needed.data(), m_tiles_high, m_tiles_wide, m_tiles_wide, 1, ring_y );
+}
+
+void TiledStepper::update_activity(void) noexcept
+{
+    const auto& planes = m_planes[m_current];
+
+    for ( auto tile = uint32_t{ 0 }; tile < m_tiles_wide * m_tiles_high; ++tile )
+    {
+        if ( m_stats_enabled )
+        {
+            m_tile_stats[tile]  = scan_tile(planes, tile);
+            m_tile_active[tile] = is_active(m_tile_stats[tile]) ? 1 : 0;
+        }
+        else
+        {
+            m_tile_active[tile] = is_tile_live(planes, tile) ? 1 : 0;
+        }
+
+        m_tile_synced[tile] = 0;
+    }
+
+    if ( m_stats_enabled )
+    {
+        m_generation_stats.clear();
+
+        sum_stats(1);
+    }
+}
+
+} // namespace field
@@ -0,0 +1,271 @@
+//
+//  TiledStepper.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <Field/Grid.hpp>
+#include <Field/StepKernel.hpp>
+#include <Field/WorkerPool.hpp>
+
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • StepStats
+//
+//  Cells of the field or of a tile after a generation: alive, those that
+//  became alive or dead during it, and those still stepping
+//===------------------------------------------------------------------------===
+
+struct StepStats
+{
+    uint64_t    population;
+    uint64_t    births;
+    uint64_t    deaths;
+    uint64_t    transitioning;
+};
+
+//===------------------------------------------------------------------------===
+//
+// • TiledStepper
+//
+//  Multithreaded toroidal stepping with the same decomposition as
+//  StepField.m: the field is divided into 32x32 tiles, and the worker
+//  stepping a tile first copies its alive cells with their one cell border
+//  (34x34, wrapped at the field edges) into a private scratch block, the
+//  host equivalent of the threadgroup memory in step_field. The field is
+//  held as byte planes so that the copies are plain row copies and the step
+//  kernels write their results directly. Tiles are balanced across workers
+//  by work stealing.
+//
+//  Several generations can be advanced per pass with temporal blocking: a
+//  block of 4x4 tiles is read with a halo as wide as the number of
+//  generations, stepped that many times in scratch (the valid region
+//  shrinking by one cell per generation) and only then written back, so the
+//  field is streamed through memory once per pass instead of once per
+//  generation. Results are identical to stepping one generation at a time.
+//
+//  Each tile has an activity flag, set while it has a live cell or a cell
+//  still stepping. A tile whose neighborhood (itself and the eight tiles
+//  around it, or the block and its ring of tiles) is inactive cannot change
+//  and is skipped, costing at most a copy into the other planes, and none
+//  if it was skipped in the previous step as well. Skipping is disabled for
+//  rules with birth on zero neighbors.
+//
+//  Stats are opt-in. When enabled, counted kernels sum each row from the
+//  masks they already build, into counters owned by the tile (or by the
+//  block, for the generations inside a pass) that are summed in tile order
+//  afterwards, so totals do not depend on scheduling, and tile activity is
+//  taken from the same counters. Per-tile stats are those of the last
+//  generation; totals are kept for every generation of the last step call.
+//  Otherwise the plain kernels run, activity comes from a scan of each
+//  stepped tile while it is in cache, and the stats are zero.
+//
+//  Stochastic rules are stepped by the kernels and then have their chances
+//  applied to each row, drawn from the field position and generation of
+//  every cell, so they step identically for any worker count or depth.
+//  Rows are stepped by the kernel of the rule's topology for their parity.
+//
+//===------------------------------------------------------------------------===
+
+class TiledStepper
+{
+public:
+
+    // • Constants
+    //
+    enum : uint32_t
+    {
+        tile_size     = 32,     // Same as the step_field threadgroup size
+        block_size    = 128,    // Temporal blocking: 4x4 tiles
+        default_depth = 8,      // Temporal blocking: generations per pass
+        max_depth     = 32
+    };
+
+    // • Initialization (0 workers = one per hardware thread)
+    //
+    TiledStepper(uint32_t width, uint32_t height, uint32_t worker_count = 0) noexcept(false);
+
+    // • Accessors : dimensions
+    //
+    constexpr uint32_t width(void) const noexcept
+    {
+        return m_width;
+    }
+
+    constexpr uint32_t height(void) const noexcept
+    {
+        return m_height;
+    }
+
+    constexpr uint32_t tiles_wide(void) const noexcept
+    {
+        return m_tiles_wide;
+    }
+
+    constexpr uint32_t tiles_high(void) const noexcept
+    {
+        return m_tiles_high;
+    }
+
+    uint32_t worker_count(void) const noexcept
+    {
+        return m_pool.worker_count();
+    }
+
+    constexpr uint64_t generation(void) const noexcept
+    {
+        return m_generation;
+    }
+
+    // • Accessors : values
+    //
+    FieldValue value(uint32_t x, uint32_t y) const noexcept;
+
+    // • Accessors : activity
+    //
+    bool is_tile_active(uint32_t tile_x, uint32_t tile_y) const noexcept
+    {
+        return 0 != m_tile_active[tile_y * m_tiles_wide + tile_x];
+    }
+
+    uint32_t active_tile_count(void) const noexcept;
+
+    // • Accessors : stats (after load or enabling, the current cells with no
+    //      births or deaths; zero while disabled)
+    //
+    constexpr bool stats_enabled(void) const noexcept
+    {
+        return m_stats_enabled;
+    }
+
+    const StepStats& stats(void) const noexcept
+    {
+        return m_generation_stats.back();
+    }
+
+    const std::vector<StepStats>& generation_stats(void) const noexcept
+    {
+        return m_generation_stats;
+    }
+
+    const StepStats& tile_stats(uint32_t tile_x, uint32_t tile_y) const noexcept
+    {
+        return m_tile_stats[tile_y * m_tiles_wide + tile_x];
+    }
+
+    // • Methods : transfer
+    //
+    void load(const Grid& grid, uint64_t generation = 0) noexcept(false);
+    void store(Grid& grid) const noexcept(false);
+
+    // • Methods : stats (disabled initially)
+    //
+    void set_stats_enabled(bool enabled) noexcept;
+
+    // • Methods : step (radius 1 neighborhoods, torus boundary only)
+    //
+    void step(const AutomatRule& rule) noexcept;
+    void step(const AutomatRule& rule, uint32_t generations, uint32_t depth = default_depth) noexcept;
+
+private:
+
+    // • Planes (private)
+    //
+    struct Planes
+    {
+        std::vector<uint8_t>    alive;      // stride m_stride, values 0 or 1
+        std::vector<uint8_t>    step;       // stride m_stride
+        std::vector<uint8_t>    duration;   // stride m_stride
+    };
+
+    // • Per-worker tile scratch (private)
+    //
+    struct alignas(64) Scratch
+    {
+        uint8_t alive[ (tile_size + 2) * (tile_size + 2) ];
+    };
+
+    // • Per-worker temporal blocking scratch (private)
+    //
+    struct BlockScratch
+    {
+        std::vector<uint8_t>    alive[2];
+        std::vector<uint8_t>    step[2];
+        std::vector<uint8_t>    duration[2];
+    };
+
+    void step_generation(const AutomatRule& rule) noexcept;
+    void step_tile(uint32_t tile, Scratch& scratch, const AutomatRule& rule) noexcept;
+    void step_block(uint32_t block, uint32_t depth, BlockScratch& scratch, const AutomatRule& rule) noexcept;
+    void copy_tile(uint32_t tile) noexcept;
+
+    // • Activity (private)
+    //
+    StepStats scan_tile(const Planes& planes, uint32_t tile) const noexcept;
+    bool      is_tile_live(const Planes& planes, uint32_t tile) const noexcept;
+    void      dilate_activity(uint32_t ring_x, uint32_t ring_y) noexcept;
+    void      update_activity(void) noexcept;
+    void      run_work(uint32_t depth, const AutomatRule& rule) noexcept;
+    void      sum_stats(uint32_t depth) noexcept;
+
+    void read_span(const std::vector<uint8_t>& plane, int64_t left, int64_t top,
+                   uint32_t span_width, uint32_t span_height, uint8_t* dest) const noexcept;
+
+    // • Data members
+    //
+    uint32_t                    m_width;
+    uint32_t                    m_height;
+    uint32_t                    m_stride;
+    Planes                      m_planes[2];
+    uint32_t                    m_current;
+    uint64_t                    m_generation;
+    uint32_t                    m_tiles_wide;
+    uint32_t                    m_tiles_high;
+    uint32_t                    m_blocks_wide;
+    uint32_t                    m_blocks_high;
+
+    StepRowKernel               m_kernel;
+    StepRowKernel               m_odd_kernel;   // odd rows, hexagonal topology
+    StepRowKernel               m_counted_kernel;
+    StepRowKernel               m_counted_odd_kernel;
+    WorkerPool                  m_pool;
+    std::vector<Scratch>        m_scratch;
+    std::vector<BlockScratch>   m_block_scratch;
+
+    std::vector<uint8_t>        m_tile_active;  // live or stepping cells in the current planes
+    std::vector<uint8_t>        m_tile_synced;  // tile identical in both planes
+    std::vector<uint8_t>        m_tile_needed;  // active tile within the ring
+    std::vector<uint8_t>        m_tile_dilated; // active tile within the ring, along rows only
+    std::vector<uint32_t>       m_work;         // tiles or blocks to step
+    std::vector<uint32_t>       m_copies;       // skipped tiles to copy
+
+    bool                        m_stats_enabled;
+    std::vector<StepStats>      m_tile_stats;       // last generation
+    std::vector<StepStats>      m_block_stats;      // max_depth per block, earlier generations of a pass
+    std::vector<StepStats>      m_generation_stats; // every generation of the last step call
+};
+
+} // namespace field
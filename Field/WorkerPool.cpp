@@ -0,0 +1,246 @@
+//
+//  WorkerPool.cpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <Field/WorkerPool.hpp>
+
+#include <algorithm>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+// • namespace <anonymous>
+//===------------------------------------------------------------------------===
+
+namespace
+{
+
+constexpr uint64_t make_bounds(uint32_t begin, uint32_t end) noexcept
+{
+    return uint64_t{ begin } | ( uint64_t{ end } << 32 );
+}
+
+constexpr uint32_t begin_of(uint64_t bounds) noexcept
+{
+    return static_cast<uint32_t>( bounds );
+}
+
+constexpr uint32_t end_of(uint64_t bounds) noexcept
+{
+    return static_cast<uint32_t>( bounds >> 32 );
+}
+
+} // namespace <anonymous>
+
+//===------------------------------------------------------------------------===
+// • Initialization
+//===------------------------------------------------------------------------===
+
+WorkerPool::WorkerPool(uint32_t worker_count) noexcept(false)
+    :
+        m_worker_count{ ( 0 < worker_count )
+                            ? worker_count
+                            : std::max( 1u, std::thread::hardware_concurrency() ) },
+        m_ranges      { new Range[m_worker_count] },
+        m_generation  { 0       },
+        m_active      { 0       },
+        m_exit        { false   },
+        m_task        { nullptr }
+{
+    for ( auto worker = uint32_t{ 0 }; worker < m_worker_count; ++worker )
+    {
+        m_ranges[worker].bounds.store( make_bounds(0, 0), std::memory_order_relaxed );
+    }
+
+    m_threads.reserve(m_worker_count - 1u);
+
+    for ( auto worker = uint32_t{ 1 }; worker < m_worker_count; ++worker )
+    {
+        m_threads.emplace_back( &WorkerPool::thread_main, this, worker );
+    }
+}
+
+WorkerPool::~WorkerPool(void) noexcept
+{
+    {
+        std::lock_guard lock{ m_mutex };
+        m_exit = true;
+    }
+
+    m_start.notify_all();
+
+    for ( auto& thread : m_threads )
+    {
+        thread.join();
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • Methods
+//===------------------------------------------------------------------------===
+
+void WorkerPool::run(uint32_t task_count, const Task& task) noexcept
+{
+    if ( 0 == task_count ) {
+        return;
+    }
+
+    if ( 1 == m_worker_count )
+    {
+        for ( auto index = uint32_t{ 0 }; index < task_count; ++index )
+        {
+            task(0, index);
+        }
+
+        return;
+    }
+
+    // • Initial contiguous ranges, one per worker
+    //
+    for ( auto worker = uint32_t{ 0 }; worker < m_worker_count; ++worker )
+    {
+        const auto begin = static_cast<uint32_t>( uint64_t{ task_count } * worker / m_worker_count );
+        const auto end   = static_cast<uint32_t>( uint64_t{ task_count } * (worker + 1u) / m_worker_count );
+
+        m_ranges[worker].bounds.store( make_bounds(begin, end), std::memory_order_relaxed );
+    }
+
+    {
+        std::lock_guard lock{ m_mutex };
+
+        m_task   = &task;
+        m_active = m_worker_count - 1u;
+        ++m_generation;
+    }
+
+    m_start.notify_all();
+
+    work(0);
+
+    std::unique_lock lock{ m_mutex };
+
+    m_finish.wait( lock, [this] { return 0 == m_active; } );
+    m_task = nullptr;
+}
+
+//===------------------------------------------------------------------------===
+// • Work stealing
+//===------------------------------------------------------------------------===
+
+bool WorkerPool::pop(uint32_t worker, uint32_t& task) noexcept
+{
+    auto& bounds = m_ranges[worker].bounds;
+    auto  value  = bounds.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        const auto begin = begin_of(value);
+        const auto end   = end_of(value);
+
+        if ( end <= begin ) {
+            return false;
+        }
+
+        if ( bounds.compare_exchange_weak( value, make_bounds(begin + 1u, end),
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire ) )
+        {
+            task = begin;
+            return true;
+        }
+    }
+}
+
+bool WorkerPool::steal(uint32_t worker, uint32_t& task) noexcept
+{
+    for ( auto offset = uint32_t{ 1 }; offset < m_worker_count; ++offset )
+    {
+        auto& bounds = m_ranges[ (worker + offset) % m_worker_count ].bounds;
+        auto  value  = bounds.load(std::memory_order_acquire);
+
+        for (;;)
+        {
+            const auto begin = begin_of(value);
+            const auto end   = end_of(value);
+
+            if ( end <= begin ) {
+                break;
+            }
+
+            // • Take the back half, run its first task now and keep the rest
+            //      as this worker's own (currently empty) range
+            //
+            const auto split = end - (end - begin + 1u) / 2u;
+
+            if ( bounds.compare_exchange_weak( value, make_bounds(begin, split),
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire ) )
+            {
+                m_ranges[worker].bounds.store( make_bounds(split + 1u, end), std::memory_order_release );
+
+                task = split;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void WorkerPool::work(uint32_t worker) noexcept
+{
+    auto task = uint32_t{ 0 };
+
+    while ( pop(worker, task) || steal(worker, task) )
+    {
+        (*m_task)(worker, task);
+    }
+}
+
+void WorkerPool::thread_main(uint32_t worker) noexcept
+{
+    auto generation = uint64_t{ 0 };
+
+    std::unique_lock lock{ m_mutex };
+
+    for (;;)
+    {
+        m_start.wait( lock, [&] { return m_exit || generation != m_generation; } );
+
+        if ( m_exit ) {
+            return;
+        }
+
+        generation = m_generation;
+
+        lock.unlock();
+        work(worker);
+        lock.lock();
+
+        if ( 0 == --m_active ) {
+            m_finish.notify_one();
+        }
+    }
+}
+
+} // namespace field
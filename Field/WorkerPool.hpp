@@ -0,0 +1,108 @@
+//
+//  WorkerPool.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//===------------------------------------------------------------------------===
+// • namespace field
+//===------------------------------------------------------------------------===
+
+namespace field
+{
+
+//===------------------------------------------------------------------------===
+//
+// • WorkerPool
+//
+//  Persistent threads running indexed tasks with work stealing. Each run
+//  splits [0, task_count) into one contiguous range per worker; a worker
+//  takes tasks from the front of its own range and, once that is empty,
+//  steals the back half of another worker's range. The calling thread
+//  participates as worker 0 and run() returns when every task has finished.
+//
+//===------------------------------------------------------------------------===
+
+class WorkerPool
+{
+public:
+
+    // • Types
+    //
+    using Task = std::function<void(uint32_t worker, uint32_t task)>;
+
+    // • Initialization (0 = one worker per hardware thread)
+    //
+    explicit WorkerPool(uint32_t worker_count = 0) noexcept(false);
+    ~WorkerPool(void) noexcept;
+
+    WorkerPool(const WorkerPool& ) = delete;
+    WorkerPool& operator = (const WorkerPool& ) = delete;
+
+    // • Accessors
+    //
+    uint32_t worker_count(void) const noexcept
+    {
+        return m_worker_count;
+    }
+
+    // • Methods
+    //
+    void run(uint32_t task_count, const Task& task) noexcept;
+
+private:
+
+    // • Work stealing (private)
+    //
+    struct alignas(64) Range
+    {
+        std::atomic<uint64_t>   bounds;     // begin in the low 32 bits, end in the high
+    };
+
+    bool pop(uint32_t worker, uint32_t& task) noexcept;
+    bool steal(uint32_t worker, uint32_t& task) noexcept;
+
+    void work(uint32_t worker) noexcept;
+    void thread_main(uint32_t worker) noexcept;
+
+    // • Data members
+    //
+    uint32_t                    m_worker_count;
+    std::unique_ptr<Range[]>    m_ranges;
+    std::vector<std::thread>    m_threads;
+
+    std::mutex                  m_mutex;
+    std::condition_variable     m_start;
+    std::condition_variable     m_finish;
+    uint64_t                    m_generation;
+    uint32_t                    m_active;
+    bool                        m_exit;
+
+    const Task*                 m_task;
+};
+
+} // namespace field
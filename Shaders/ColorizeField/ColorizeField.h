@@ -39,6 +39,7 @@
                  fromBuffer:(nonnull id<MTLBuffer>)buffer
                    atOffset:(NSInteger)colorizeFieldOffset
              currentSubstep:(uint8_t)currentSubstep
+                 ruleOffset:(NSInteger)ruleOffset
                fieldTexture:(nonnull id<MTLTexture>)fieldTexture
       colorizedFieldTexture:(nonnull id<MTLTexture>)colorizedFieldTexture;
 
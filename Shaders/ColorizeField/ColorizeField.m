@@ -64,6 +64,7 @@
                  fromBuffer:(nonnull id<MTLBuffer>)buffer
                    atOffset:(NSInteger)colorizeFieldOffset
              currentSubstep:(uint8_t)currentSubstep
+                 ruleOffset:(NSInteger)ruleOffset
                fieldTexture:(nonnull id<MTLTexture>)fieldTexture
       colorizedFieldTexture:(nonnull id<MTLTexture>)colorizedFieldTexture {
 
@@ -74,6 +75,7 @@
     [computeEncoder setBuffer:buffer offset:0 atIndex:1];
 
     [computeEncoder setBytes:&currentSubstep length:sizeof(currentSubstep) atIndex:2];
+    [computeEncoder setBuffer:buffer offset:ruleOffset atIndex:3];
 
     [computeEncoder setTexture:fieldTexture atIndex:0];
     [computeEncoder setTexture:colorizedFieldTexture atIndex:1];
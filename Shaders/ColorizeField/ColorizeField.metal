@@ -20,8 +20,9 @@
 #include <metal_stdlib>
 using namespace metal;
 
+#include <Shaders/Data/AutomatRule.hpp>
 #include <Shaders/Data/FieldColorization.hpp>
-#include <Shaders/Data/FieldValue.hpp>
+#include <Shaders/Data/PackedCell.hpp>
 #include <Shaders/Data/Vertex.hpp>
 
 #include <Graphics/Geometry.hpp>
@@ -40,7 +41,9 @@ namespace
 // • colorize_cell
 //===------------------------------------------------------------------------===
 
-float4 colorize_cell(FieldValue                  cell,
+float4 colorize_cell(bool                        alive,
+                     uint                        step,
+                     uint                        duration,
                      ushort                      substep,
                      constant FieldColorization& colorization [[ buffer(0) ]],
                      constant uint8_t*           base         [[ buffer(1) ]])
@@ -50,10 +53,10 @@ float4 colorize_cell(FieldValue                  cell,
     //    The algorithm counts down from transition duration to zero, so the
     //    position along the gradient is logically reversed
     //
-    constant auto& segments = (cell.alive) ? colorization.growth : colorization.decline;
+    constant auto& segments = (alive) ? colorization.growth : colorization.decline;
 
-    const auto step_position  = colorization.step_duration * (cell.duration - cell.step) + substep;
-    const auto total_duration = colorization.step_duration *  cell.duration;
+    const auto step_position  = colorization.step_duration * (duration - step) + substep;
+    const auto total_duration = colorization.step_duration *  duration;
     const auto u              = (float(step_position) + 0.5f) / float(total_duration);
 
     constant auto* S = data::cdata(segments, base);
@@ -102,6 +105,7 @@ struct ColorizationData
     constant FieldColorization&    colorization    [[ buffer(0)                      ]],
     constant uint8_t*              base            [[ buffer(1)                      ]],
     constant uint8_t&              substep         [[ buffer(2)                      ]],
+    constant AutomatRule&          rule            [[ buffer(3)                      ]],
     texture2d<ushort,access::read> field           [[ texture(0)                     ]],
     texture2d<half,access::write>  colorized_field [[ texture(1)                     ]],
     uint2                          pos             [[ thread_position_in_grid        ]],
@@ -115,13 +119,18 @@ struct ColorizationData
 
     if ( geometry::contains(colorization.region, pos) )
     {
-        const auto cell = FieldValue{ field.read(pos) };
+        const PackedCell cell = field.read(pos).r;
+        const auto       step = packed_step(cell);
 
-        if ( 0 < cell.step )
+        if ( 0 < step )
         {
-            // • Transition - use colorization from gradient
+            // • Transition - use colorization from gradient, counting down
+            //      from the rule's duration for the cell's state
             //
-            lrgba = colorize_cell(cell, substep, colorization, base);
+            const auto alive    = packed_alive(cell);
+            const auto duration = (alive) ? rule.growth_duration : rule.decline_duration;
+
+            lrgba = colorize_cell(alive, step, duration, substep, colorization, base);
         }
     }
 
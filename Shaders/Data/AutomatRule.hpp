@@ -23,8 +23,49 @@
 
 //===------------------------------------------------------------------------===
 // • AutomatRule
+//
+//  A radius of 0 or 1 is the Moore neighborhood, where born and survive are
+//  masks of neighbor counts. A larger radius, up to max_neighborhood_radius
+//  (Larger than Life), counts the (2r + 1)^2 - 1 cells of the square around
+//  the cell, which is born or survives when the count lies in the inclusive
+//  range, and the masks are ignored.
+//
+//  The topology shapes a radius 0 or 1 neighborhood: the eight cells around
+//  the cell (Moore), the four orthogonal ones (von Neumann), or the six of a
+//  hexagonal grid stored in offset rows, where odd rows sit half a cell to
+//  the right of even rows (see Neighborhood.hpp). Larger than Life is always
+//  square.
+//
+//  The boundary decides what lies beyond the edges of the field: the far
+//  edge (a torus, which tiles), dead cells (a framed field), or the field
+//  reflected about the edge, so that the cell before the first is the first.
+//
+//  Nonzero chances make the rule stochastic: a settled cell whose count would
+//  bear it is born only when its draw passes born_chance, and one whose count
+//  would keep it survives only when its draw passes survive_chance, both in
+//  65536ths. Draws come from cell_random keyed by the seed, so zero chances
+//  (the default) are the deterministic rule.
 //===------------------------------------------------------------------------===
 
+enum : uint8_t
+{
+    max_neighborhood_radius = 15
+};
+
+enum : uint8_t
+{
+    topology_moore       = 0,
+    topology_von_neumann = 1,
+    topology_hexagonal   = 2
+};
+
+enum : uint8_t
+{
+    boundary_torus  = 0,
+    boundary_dead   = 1,
+    boundary_mirror = 2
+};
+
 struct AutomatRule
 {
     uint16_t    born;
@@ -32,8 +73,48 @@ struct AutomatRule
 
     uint8_t     growth_duration;
     uint8_t     decline_duration;
+
+    uint8_t     radius;
+    uint8_t     boundary;
+
+    uint16_t    born_min;
+    uint16_t    born_max;
+    uint16_t    survive_min;
+    uint16_t    survive_max;
+
+    uint16_t    born_chance;
+    uint16_t    survive_chance;
+    uint32_t    seed;
+
+    uint8_t     topology;
+    uint8_t     reserved[3];
 };
 
 #if !defined ( __METAL_VERSION__ )
 static_assert( data::is_trivial_layout<AutomatRule>(), "Unexpected layout" );
 #endif
+
+//===------------------------------------------------------------------------===
+// • boundary_index
+//
+//  Index within an axis of count cells of the cell at index, which may lie
+//  any distance beyond either edge, or -1 for a dead cell
+//===------------------------------------------------------------------------===
+
+constexpr int boundary_index(int index, int count, uint8_t boundary)
+{
+    if (boundary_dead == boundary)
+    {
+        return (0 <= index && index < count) ? index : -1;
+    }
+
+    if (boundary_mirror == boundary)
+    {
+        const auto period = 2 * count;
+        const auto i      = (index % period + period) % period;
+
+        return (i < count) ? i : period - 1 - i;
+    }
+
+    return (index % count + count) % count;
+}
@@ -0,0 +1,81 @@
+//
+//  CellRandom.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#if defined ( __METAL_VERSION__ )
+#include <metal_stdlib>
+#else
+#include <cstdint>
+#endif
+
+//===------------------------------------------------------------------------===
+//
+// • cell_random
+//
+//  Counter-based random draw of one cell in one generation: Philox4x32-10
+//  with the cell position and generation as the counter and the rule's seed
+//  as the key, returning the first word. Each draw is a pure function of its
+//  arguments, so any thread, SIMD lane or GPU thread computes the same value
+//  for a cell without sharing any state, and a stochastic field steps
+//  identically whatever the engine, thread count or tile order.
+//
+//===------------------------------------------------------------------------===
+
+enum : uint32_t
+{
+    cell_random_stream = 0x54587374     // second key word: 'TXst'
+};
+
+constexpr uint32_t cell_random(uint32_t seed, uint64_t generation, uint32_t x, uint32_t y)
+{
+    auto c0 = x;
+    auto c1 = y;
+    auto c2 = static_cast<uint32_t>( generation );
+    auto c3 = static_cast<uint32_t>( generation >> 32 );
+    auto k0 = seed;
+    auto k1 = uint32_t{ cell_random_stream };
+
+    for (auto round = 0; round < 10; ++round)
+    {
+        const auto p0 = uint64_t{ 0xD2511F53u } * c0;
+        const auto p1 = uint64_t{ 0xCD9E8D57u } * c2;
+
+        c0 = static_cast<uint32_t>( p1 >> 32 ) ^ c1 ^ k0;
+        c1 = static_cast<uint32_t>( p1 );
+        c2 = static_cast<uint32_t>( p0 >> 32 ) ^ c3 ^ k1;
+        c3 = static_cast<uint32_t>( p0 );
+
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+
+    return c0;
+}
+
+//===------------------------------------------------------------------------===
+// • passes_chance
+//
+//  Whether a draw passes a chance in 65536ths, where a chance of 0 is
+//  certainty. A draw of 0 passes every chance.
+//===------------------------------------------------------------------------===
+
+constexpr bool passes_chance(uint16_t chance, uint32_t draw)
+{
+    return 0 == chance || draw < (uint32_t{ chance } << 16);
+}
@@ -19,13 +19,14 @@
 
 #pragma once
 
-#if defined ( __METAL_VERSION__ )
-
-#include <metal_stdlib>
+#include <Data/Layout.hpp>
 
 //===------------------------------------------------------------------------===
 //
-// • FieldValue (Metal only)
+// • FieldValue
+//
+//  Host cell with its state unpacked into bytes. The field textures hold
+//  PackedCells, which leave the duration to the rule (see CellPacking.hpp)
 //
 //===------------------------------------------------------------------------===
 
@@ -36,14 +37,8 @@ struct FieldValue
     uint8_t duration;
     uint8_t reserved;
 
-    FieldValue(ushort4 src)
-        :
-            alive   { static_cast<uint8_t>(src[0]) },
-            step    { static_cast<uint8_t>(src[1]) },
-            duration{ static_cast<uint8_t>(src[2]) },
-            reserved{ 0u }
-    {
-    }
+    constexpr bool operator == (const FieldValue& ) const noexcept = default;
 };
 
-#endif // defined ( __METAL_VERSION__ )
+static_assert( 4 == sizeof(FieldValue), "Unexpected size" );
+static_assert( data::is_trivial_layout<FieldValue>(), "Unexpected layout" );
@@ -0,0 +1,114 @@
+//
+//  Neighborhood.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+#pragma once
+
+#include <Shaders/Data/AutomatRule.hpp>
+#include <Shaders/Data/PackedCell.hpp>
+
+//===------------------------------------------------------------------------===
+// • neighbor_alive
+//
+//  Alive value of a neighbor, either a byte plane value (0 or 1) on the
+//  host or a packed cell in the shaders
+//===------------------------------------------------------------------------===
+
+constexpr uint32_t neighbor_alive(uint8_t alive)
+{
+    return alive;
+}
+
+constexpr uint32_t neighbor_alive(PackedCell cell)
+{
+    return packed_alive(cell) ? 1u : 0u;
+}
+
+//===------------------------------------------------------------------------===
+//
+// • Neighborhood
+//
+//  Radius 1 neighbor count of a topology, unrolled at compile time. The
+//  three rows point at the cell's column in the rows above, of and below
+//  the cell, and are read from [-1] to [1].
+//
+//  On the hexagonal grid odd rows are shifted half a cell right, so the
+//  cells above and below an even row cell are at [-1] and [0], and those of
+//  an odd row cell at [0] and [1]. The parity is a template parameter so
+//  that every row is a fixed stencil. On a torus the field height should be
+//  even for the offset rows to tile across the wrap.
+//
+//===------------------------------------------------------------------------===
+
+template <uint8_t Topology_, bool OddRow_>
+struct Neighborhood;
+
+template <bool OddRow_>
+struct Neighborhood<topology_moore, OddRow_>
+{
+    static constexpr uint32_t max_count = 8;
+
+    template <typename Row_>
+    static constexpr uint32_t count(Row_ upper, Row_ middle, Row_ lower)
+    {
+        return neighbor_alive(upper[-1])  + neighbor_alive(upper[0]) + neighbor_alive(upper[1])
+             + neighbor_alive(middle[-1])                            + neighbor_alive(middle[1])
+             + neighbor_alive(lower[-1])  + neighbor_alive(lower[0]) + neighbor_alive(lower[1]);
+    }
+};
+
+template <bool OddRow_>
+struct Neighborhood<topology_von_neumann, OddRow_>
+{
+    static constexpr uint32_t max_count = 4;
+
+    template <typename Row_>
+    static constexpr uint32_t count(Row_ upper, Row_ middle, Row_ lower)
+    {
+        return                              neighbor_alive(upper[0])
+             + neighbor_alive(middle[-1])                            + neighbor_alive(middle[1])
+             +                              neighbor_alive(lower[0]);
+    }
+};
+
+template <>
+struct Neighborhood<topology_hexagonal, false>
+{
+    static constexpr uint32_t max_count = 6;
+
+    template <typename Row_>
+    static constexpr uint32_t count(Row_ upper, Row_ middle, Row_ lower)
+    {
+        return neighbor_alive(upper[-1])  + neighbor_alive(upper[0])
+             + neighbor_alive(middle[-1])                            + neighbor_alive(middle[1])
+             + neighbor_alive(lower[-1])  + neighbor_alive(lower[0]);
+    }
+};
+
+template <>
+struct Neighborhood<topology_hexagonal, true>
+{
+    static constexpr uint32_t max_count = 6;
+
+    template <typename Row_>
+    static constexpr uint32_t count(Row_ upper, Row_ middle, Row_ lower)
+    {
+        return                              neighbor_alive(upper[0])  + neighbor_alive(upper[1])
+             + neighbor_alive(middle[-1])                             + neighbor_alive(middle[1])
+             +                              neighbor_alive(lower[0])  + neighbor_alive(lower[1]);
+    }
+};
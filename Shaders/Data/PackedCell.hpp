@@ -0,0 +1,67 @@
+//
+//  PackedCell.hpp
+//
+//  Copyright © 2024 Robert Guequierre
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#pragma once
+
+#if defined ( __METAL_VERSION__ )
+#include <metal_stdlib>
+#else
+#include <cstdint>
+#endif
+
+//===------------------------------------------------------------------------===
+//
+// • PackedCell
+//
+//  One field texel: bit 7 is alive and the countdown is bits 0-6, continued
+//  in bits 8-15. The transition duration is not stored, since a cell that is
+//  counting down started from the rule's growth_duration when alive and its
+//  decline_duration when not.
+//
+//  While both durations fit in 7 bits the high byte is always zero and the
+//  cell fits an R8Uint texel; otherwise it takes an R16Uint texel. Either
+//  reads as the same ushort, so the shaders do not depend on the format.
+//
+//===------------------------------------------------------------------------===
+
+typedef uint16_t PackedCell;
+
+enum : uint16_t
+{
+    packed_cell_alive      = 0x0080,
+    packed_cell8_max_step  = 0x007f,
+    packed_cell16_max_step = 0x7fff
+};
+
+constexpr PackedCell make_packed_cell(bool alive, uint32_t step)
+{
+    return static_cast<PackedCell>( (alive ? uint32_t{ packed_cell_alive } : 0u)
+                                  | (step & 0x7fu)
+                                  | ((step >> 7) << 8) );
+}
+
+constexpr bool packed_alive(PackedCell cell)
+{
+    return 0 != (cell & packed_cell_alive);
+}
+
+constexpr uint32_t packed_step(PackedCell cell)
+{
+    return (uint32_t{ cell } & 0x7fu) | ((uint32_t{ cell } >> 8) << 7);
+}
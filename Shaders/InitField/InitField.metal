@@ -21,7 +21,7 @@
 using namespace metal;
 
 #include <Shaders/Data/FieldInitialization.hpp>
-#include <Shaders/Data/FieldValue.hpp>
+#include <Shaders/Data/PackedCell.hpp>
 #include <Shaders/Data/Vertex.hpp>
 
 //===------------------------------------------------------------------------===
@@ -30,7 +30,7 @@ using namespace metal;
 
 [[fragment]] ushort4 init_field_fragment(void)
 {
-    return { 1u, 0u, 0u, 0u };
+    return { make_packed_cell(true, 0), 0u, 0u, 0u };
 }
 
 //===------------------------------------------------------------------------===
@@ -39,6 +39,10 @@
                  fromBuffer:(nonnull id<MTLBuffer>)buffer
                    atOffset:(NSInteger)stepFieldOffset
          sourceFieldTexture:(nonnull id<MTLTexture>)sourceFieldTexture
-    destinationFieldTexture:(nonnull id<MTLTexture>)destFieldTexture;
+    destinationFieldTexture:(nonnull id<MTLTexture>)destFieldTexture
+         neighborhoodRadius:(NSInteger)radius
+       neighborhoodTopology:(uint8_t)topology
+                 generation:(uint64_t)generation
+                       rows:(NSRange)rows;
 
 @end
@@ -25,7 +25,8 @@
 
 @implementation StepField
 {
-    id<MTLComputePipelineState>  pipelineState;
+    id<MTLComputePipelineState>  pipelineStates[3];   // topology_moore ... topology_hexagonal
+    id<MTLComputePipelineState>  largerThanLifePipelineState;
 }
 
 //===------------------------------------------------------------------------===
@@ -38,17 +39,41 @@
 
     if (nil != self) {
 
-        id<MTLFunction> computeFunction = [library newFunctionWithName:@"step_field"];
+        // • One specialization of step_field per topology
+        //
+        NSError *error = nil;
 
-        if (nil == computeFunction) {
-            return nil;
+        for (uint32_t topology = 0; topology < 3; ++topology) {
+
+            MTLFunctionConstantValues *constantValues = [MTLFunctionConstantValues new];
+
+            [constantValues setConstantValue:&topology type:MTLDataTypeUInt atIndex:0];
+
+            id<MTLFunction> computeFunction = [library newFunctionWithName:@"step_field"
+                                                            constantValues:constantValues
+                                                                     error:&error];
+            if (nil == computeFunction || nil != error) {
+                return nil;
+            }
+
+            pipelineStates[topology] = [library.device newComputePipelineStateWithFunction:computeFunction
+                                                                                     error:&error];
+            if (nil == pipelineStates[topology] || nil != error) {
+                return nil;
+            }
         }
 
-        NSError *error = nil;
+        // • Larger than Life
+        //
+        id<MTLFunction> largerThanLifeFunction = [library newFunctionWithName:@"step_field_ltl"];
+
+        if (nil == largerThanLifeFunction) {
+            return nil;
+        }
 
-        pipelineState = [library.device newComputePipelineStateWithFunction:computeFunction
-                                                                      error:&error];
-        if (nil == pipelineState || nil != error) {
+        largerThanLifePipelineState = [library.device newComputePipelineStateWithFunction:largerThanLifeFunction
+                                                                                     error:&error];
+        if (nil == largerThanLifePipelineState || nil != error) {
             return nil;
         }
     }
@@ -64,20 +89,62 @@
                  fromBuffer:(nonnull id<MTLBuffer>)buffer
                    atOffset:(NSInteger)stepFieldOffset
          sourceFieldTexture:(nonnull id<MTLTexture>)sourceFieldTexture
-    destinationFieldTexture:(nonnull id<MTLTexture>)destFieldTexture {
+    destinationFieldTexture:(nonnull id<MTLTexture>)destFieldTexture
+         neighborhoodRadius:(NSInteger)radius
+       neighborhoodTopology:(uint8_t)topology
+                 generation:(uint64_t)generation
+                       rows:(NSRange)rows {
+
+    // • Only the rows of the band are stepped, which must begin on a
+    //      threadgroup boundary so the tiles match those of a whole step
+    //
+    assert( 0 == rows.location % 32 );
+    assert( NSMaxRange(rows) <= destFieldTexture.height );
+
+    if (0 == rows.length) {
+        return;
+    }
+
+    const uint16_t rowOrigin = (uint16_t)rows.location;
+    const MTLSize  bandSize  = MTLSizeMake(destFieldTexture.width, rows.length, 1);
+
+    if (1 < radius) {
+
+        // • Summed-area table of the 32 x 32 tile and its border, with a
+        //      leading row and column of zeros (radius limited to
+        //      max_neighborhood_radius)
+        //
+        const NSUInteger tableSide = 32 + 2 * MIN(radius, 15) + 1;
+
+        [computeEncoder setComputePipelineState:largerThanLifePipelineState];
+        [computeEncoder setBuffer:buffer offset:stepFieldOffset atIndex:0];
+        [computeEncoder setBytes:&generation length:sizeof(generation) atIndex:1];
+        [computeEncoder setBytes:&rowOrigin length:sizeof(rowOrigin) atIndex:2];
+
+        [computeEncoder setTexture:sourceFieldTexture atIndex:0];
+        [computeEncoder setTexture:destFieldTexture atIndex:1];
+
+        [computeEncoder setThreadgroupMemoryLength:(tableSide * tableSide * 2 + 15) & ~15 atIndex:0];
+
+        [computeEncoder dispatchThreads:bandSize
+                  threadsPerThreadgroup:MTLSizeMake(32, 32, 1)];
+        return;
+    }
 
-    [computeEncoder setComputePipelineState:pipelineState];
+    [computeEncoder setComputePipelineState:pipelineStates[MIN(topology, 2)]];
     [computeEncoder setImageblockWidth:32 height:32];
     [computeEncoder setBuffer:buffer offset:stepFieldOffset atIndex:0];
+    [computeEncoder setBytes:&generation length:sizeof(generation) atIndex:1];
+    [computeEncoder setBytes:&rowOrigin length:sizeof(rowOrigin) atIndex:2];
 
     [computeEncoder setTexture:sourceFieldTexture atIndex:0];
     [computeEncoder setTexture:destFieldTexture atIndex:1];
 
-    [computeEncoder setThreadgroupMemoryLength:34 * 34 * 4 atIndex:0];
+    // • 34 x 34 packed cells: the tile and a one cell border
+    //
+    [computeEncoder setThreadgroupMemoryLength:(34 * 34 * 2 + 15) & ~15 atIndex:0];
 
-    [computeEncoder dispatchThreads:MTLSizeMake(destFieldTexture.width,
-                                                destFieldTexture.height,
-                                                1)
+    [computeEncoder dispatchThreads:bandSize
               threadsPerThreadgroup:MTLSizeMake(32, 32, 1)];
 }
 
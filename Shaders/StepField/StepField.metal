@@ -21,56 +21,125 @@
 using namespace metal;
 
 #include <Shaders/Data/AutomatRule.hpp>
-#include <Shaders/Data/FieldValue.hpp>
+#include <Shaders/Data/CellRandom.hpp>
+#include <Shaders/Data/Neighborhood.hpp>
+#include <Shaders/Data/PackedCell.hpp>
+
+//===------------------------------------------------------------------------===
+// • read_boundary
+//
+//  Reads the cell at a position that may lie beyond the edges of the field,
+//  which are resolved by the rule's boundary; a dead cell reads as zero
+//===------------------------------------------------------------------------===
+
+static PackedCell read_boundary(texture2d<ushort,access::read> field, int2 pos, int2 size, uint8_t boundary)
+{
+    const auto x = boundary_index(pos.x, size.x, boundary);
+    const auto y = boundary_index(pos.y, size.y, boundary);
+
+    if (x < 0 || y < 0) {
+        return 0;
+    }
+
+    return field.read(uint2(x, y)).r;
+}
+
+//===------------------------------------------------------------------------===
+// • count_neighbors
+//
+//  Radius 1 count of the topology the step_field pipeline was specialized
+//  for: a function constant, so the other stencils are compiled out. Row
+//  parity is uniform along each 32-thread row of the threadgroup, so the
+//  hexagonal grid does not diverge within a SIMD group.
+//===------------------------------------------------------------------------===
+
+constant uint step_topology [[ function_constant(0) ]];
+
+static uint count_neighbors(threadgroup PackedCell* upper, threadgroup PackedCell* middle,
+                            threadgroup PackedCell* lower, bool odd_row)
+{
+    switch (step_topology)
+    {
+        case topology_von_neumann:
+            return Neighborhood<topology_von_neumann, false>::count(upper, middle, lower);
+
+        case topology_hexagonal:
+            return odd_row ? Neighborhood<topology_hexagonal, true>::count(upper, middle, lower)
+                           : Neighborhood<topology_hexagonal, false>::count(upper, middle, lower);
+
+        default:
+            return Neighborhood<topology_moore, false>::count(upper, middle, lower);
+    }
+}
+
+//===------------------------------------------------------------------------===
+// • draw_passes
+//
+//  Whether the cell's draw passes a chance of the rule, drawing only when
+//  the chance is not certain
+//===------------------------------------------------------------------------===
+
+static bool draw_passes(uint16_t chance, constant AutomatRule& rule, uint64_t generation, ushort2 pos)
+{
+    return 0 == chance || passes_chance(chance, cell_random(rule.seed, generation, pos.x, pos.y));
+}
 
 //===------------------------------------------------------------------------===
 // • step
+//
+//  The grid covers a band of rows starting at row_origin, a multiple of the
+//  threadgroup height, so a generation may be stepped a slice at a time
 //===------------------------------------------------------------------------===
 
 struct FieldData
 {
-    uchar4  value;
+    ushort  cell;
 };
 
 [[kernel]] void step_field
 (
     imageblock<FieldData>           image_block,
     constant AutomatRule&           rule         [[ buffer(0)                      ]],
+    constant uint64_t&              generation   [[ buffer(1)                      ]],
+    constant ushort&                row_origin   [[ buffer(2)                      ]],
     texture2d<ushort,access::read>  source_field [[ texture(0)                     ]],
     texture2d<ushort,access::write> dest_field   [[ texture(1)                     ]],
-    threadgroup FieldValue*         shared       [[ threadgroup(0)                 ]],
-    const ushort2                   field_size   [[ threads_per_grid               ]],
-    const ushort2                   pos          [[ thread_position_in_grid        ]],
+    threadgroup PackedCell*         shared       [[ threadgroup(0)                 ]],
+    const ushort2                   grid_pos     [[ thread_position_in_grid        ]],
     const ushort2                   tg_size      [[ threads_per_threadgroup        ]],
     const ushort2                   lid          [[ thread_position_in_threadgroup ]]
 )
 {
+    const auto field_size = ushort2( source_field.get_width(), source_field.get_height() );
+    const auto pos        = grid_pos + ushort2{ 0, row_origin };
+
     // • Read source values into threadgroup memory along with a one pixel border on all sides
     //
     const auto row_offset = tg_size.x + 2u;
     const auto offset     = uint2{ lid.x, row_offset * lid.y };
     const auto alt_offset = offset + uint2{ tg_size.x, row_offset*tg_size.y };
 
-    const auto source_pos = (pos + field_size - ushort2{ 1, 1 }) % field_size;
-    const auto alt_pos    = (source_pos + tg_size) % field_size;
+    const auto size       = int2(field_size);
+    const auto source_pos = int2(pos) - int2{ 1, 1 };
+    const auto alt_pos    = source_pos + int2(tg_size);
 
     // • All threads read one pixel up and to the left
     //
-    shared[offset.y + offset.x] = source_field.read(source_pos);
+    shared[offset.y + offset.x] = read_boundary(source_field, source_pos, size, rule.boundary);
 
     if (lid.x < 2) {
         // 2 left-most columns also read the pixel offset by tg_size.x to the right
-        shared[offset.y + alt_offset.x] = source_field.read({ alt_pos.x, source_pos.y });
+        shared[offset.y + alt_offset.x] = read_boundary(source_field, { alt_pos.x, source_pos.y }, size, rule.boundary);
     }
 
     if (lid.y < 2) {
         // 2 top-most rows also read the pixel offset by tg_size.y below
-        shared[alt_offset.y + offset.x] = source_field.read({ source_pos.x, alt_pos.y });
+        shared[alt_offset.y + offset.x] = read_boundary(source_field, { source_pos.x, alt_pos.y }, size, rule.boundary);
     }
 
     if (lid.x < 2 && lid.y < 2) {
         // 4 upper-left threads also read the pixel offset by (tg_size.x, tg_size.y)
-        shared[alt_offset.y + alt_offset.x] = source_field.read(alt_pos);
+        shared[alt_offset.y + alt_offset.x] = read_boundary(source_field, alt_pos, size, rule.boundary);
     }
 
     threadgroup_barrier(mem_flags::mem_threadgroup);
@@ -79,51 +148,47 @@ struct FieldData
     //
     const auto center_offset = offset + uint2{ 1, row_offset };
 
-    auto value = shared[center_offset.y + center_offset.x];
+    const auto cell = shared[center_offset.y + center_offset.x];
+
+    auto alive = packed_alive(cell);
+    auto step  = packed_step(cell);
 
-    if (0 < value.step)
+    if (0 < step)
     {
         // • Next step
         //
-        --value.step;
+        --step;
     }
     else
     {
-        threadgroup auto* upper  = shared + offset.y + offset.x;
+        threadgroup auto* upper  = shared + offset.y + offset.x + 1u;
         threadgroup auto* middle = upper  + row_offset;
         threadgroup auto* lower  = middle + row_offset;
 
         // • Fallow or mature
         //
-        const auto neighbor_count =  upper[0].alive
-                                  +  upper[1].alive
-                                  +  upper[2].alive
-                                  + middle[0].alive
-                                  + middle[2].alive
-                                  +  lower[0].alive
-                                  +  lower[1].alive
-                                  +  lower[2].alive;
+        const auto neighbor_count = count_neighbors(upper, middle, lower, 0 != (pos.y & 1));
 
         const auto neighbors = 1 << neighbor_count;
 
-        if (value.alive)
+        if (alive)
         {
             // Mature
-            if ( 0 == (neighbors & rule.survive) )
+            if ( 0 == (neighbors & rule.survive) || !draw_passes(rule.survive_chance, rule, generation, pos) )
             {
                 // Decline
-                value.step  = value.duration = rule.decline_duration;
-                value.alive = 0;
+                step  = rule.decline_duration;
+                alive = false;
             }
         }
         else
         {
             // Fallow
-            if ( 0 != (neighbors & rule.born) )
+            if ( 0 != (neighbors & rule.born) && draw_passes(rule.born_chance, rule, generation, pos) )
             {
                 // Growth
-                value.step  = value.duration = rule.growth_duration;
-                value.alive = 1;
+                step  = rule.growth_duration;
+                alive = true;
             }
         }
     }
@@ -131,7 +196,7 @@ struct FieldData
     // • Write to image block
     //
     threadgroup_imageblock auto* field_data = image_block.data(lid);
-    field_data->value = { value.alive, value.step, value.duration, 0 };
+    field_data->cell = make_packed_cell(alive, step);
 
     threadgroup_barrier(mem_flags::mem_threadgroup_imageblock);
 
@@ -139,6 +204,133 @@ struct FieldData
     //
     if ( 0 == lid.x && 0 == lid.y )
     {
-        dest_field.write(image_block.slice(field_data->value), pos);
+        dest_field.write(image_block.slice(field_data->cell), pos);
     }
 }
+
+//===------------------------------------------------------------------------===
+// • step (Larger than Life)
+//
+//  Each threadgroup loads its tile with an r cell border into threadgroup
+//  memory and turns it into a summed-area table, one row and then one
+//  column per thread, so every neighbor count is four reads whatever the
+//  radius. The table has a leading row and column of zeros.
+//===------------------------------------------------------------------------===
+
+[[kernel]] void step_field_ltl
+(
+    constant AutomatRule&           rule         [[ buffer(0)                      ]],
+    constant uint64_t&              generation   [[ buffer(1)                      ]],
+    constant ushort&                row_origin   [[ buffer(2)                      ]],
+    texture2d<ushort,access::read>  source_field [[ texture(0)                     ]],
+    texture2d<ushort,access::write> dest_field   [[ texture(1)                     ]],
+    threadgroup ushort*             table        [[ threadgroup(0)                 ]],
+    const ushort2                   grid_pos     [[ thread_position_in_grid        ]],
+    const ushort2                   tg_size      [[ threads_per_threadgroup        ]],
+    const ushort2                   lid          [[ thread_position_in_threadgroup ]]
+)
+{
+    const auto field_size = ushort2( source_field.get_width(), source_field.get_height() );
+    const auto pos        = grid_pos + ushort2{ 0, row_origin };
+    const auto radius     = min( uint{ rule.radius }, uint{ max_neighborhood_radius } );
+    const auto span       = uint2(tg_size) + 2u * radius;
+    const auto stride     = span.x + 1u;
+    const auto thread     = uint{ lid.y } * tg_size.x + lid.x;
+    const auto tg_threads = uint{ tg_size.x } * tg_size.y;
+    const auto size       = int2(field_size);
+    const auto origin     = int2(pos - lid) - int(radius);
+
+    // • Alive values of the tile and its border, below and right of the zeros
+    //
+    for (auto i = thread; i < stride; i += tg_threads) {
+        table[i] = 0;
+    }
+
+    for (auto i = thread; i < span.y; i += tg_threads) {
+        table[(i + 1u) * stride] = 0;
+    }
+
+    for (auto i = thread; i < span.x * span.y; i += tg_threads)
+    {
+        const auto cell  = uint2{ i % span.x, i / span.x };
+        const auto value = read_boundary(source_field, origin + int2(cell), size, rule.boundary);
+
+        table[(cell.y + 1u) * stride + cell.x + 1u] = packed_alive(value) ? 1 : 0;
+    }
+
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    // • Summed-area table: prefix sums along rows, then down columns
+    //
+    for (auto y = thread; y < span.y; y += tg_threads)
+    {
+        threadgroup auto* row = table + (y + 1u) * stride;
+
+        for (auto x = 2u; x <= span.x; ++x) {
+            row[x] += row[x - 1u];
+        }
+    }
+
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    for (auto x = thread; x < span.x; x += tg_threads)
+    {
+        threadgroup auto* column = table + x + 1u;
+
+        for (auto y = 2u; y <= span.y; ++y) {
+            column[y * stride] += column[(y - 1u) * stride];
+        }
+    }
+
+    threadgroup_barrier(mem_flags::mem_threadgroup);
+
+    // • Step or count the (2r + 1)^2 window
+    //
+    const PackedCell cell = source_field.read(pos).r;
+
+    auto alive = packed_alive(cell);
+    auto step  = packed_step(cell);
+
+    if (0 < step)
+    {
+        // • Next step
+        //
+        --step;
+    }
+    else
+    {
+        const auto lo = uint2(lid);
+        const auto hi = lo + 2u * radius + 1u;
+
+        const auto neighbor_count = uint{ table[hi.y * stride + hi.x] }
+                                  - uint{ table[hi.y * stride + lo.x] }
+                                  - uint{ table[lo.y * stride + hi.x] }
+                                  + uint{ table[lo.y * stride + lo.x] }
+                                  - uint{ alive };
+
+        if (alive)
+        {
+            // Mature
+            if ( neighbor_count < rule.survive_min || rule.survive_max < neighbor_count
+              || !draw_passes(rule.survive_chance, rule, generation, pos) )
+            {
+                // Decline
+                step  = rule.decline_duration;
+                alive = false;
+            }
+        }
+        else
+        {
+            // Fallow
+            if ( rule.born_min <= neighbor_count && neighbor_count <= rule.born_max
+              && draw_passes(rule.born_chance, rule, generation, pos) )
+            {
+                // Growth
+                step  = rule.growth_duration;
+                alive = true;
+            }
+        }
+    }
+
+    dest_field.write(ushort4{ make_packed_cell(alive, step), 0, 0, 0 }, pos);
+}